@@ -0,0 +1,66 @@
+#pragma once
+#include <vector>
+#include <string>
+#include <functional>
+#include <chrono>
+#include "Model.h"
+
+// Time the GL thread may spend per frame on finishing background loads
+const double ASSET_UPLOAD_BUDGET_MS = 4.0;
+
+// Assets grouped by the game stage (GameState) that first needs them. The
+// first stage is loaded up front; while stage N is running, everything up to
+// stage N + 1 loads in the background so switching stages does not stall.
+// Models are parsed and images decoded on the worker pool; the GL thread only
+// uploads them, within a time budget per frame.
+// An asset that is late when its stage starts shows a placeholder (the
+// placeholder model, or whatever the texture callback set beforehand).
+class AssetManifest {
+public:
+    // Receives the texture name, or 0 if the image could not be loaded
+    typedef std::function<void(unsigned int)> TextureCallback;
+
+private:
+    struct ModelEntry {
+        int stage;
+        ModelHandle handle;
+    };
+
+    struct TextureEntry {
+        int stage;
+        std::string path;
+        TextureCallback onLoaded;
+        TextureHandle handle;    // Set once the stage is requested
+        bool loaded;             // onLoaded has run
+    };
+
+    ModelCache& cache;
+    std::vector<ModelEntry> models;
+    std::vector<TextureEntry> textures;
+    int requestedStage;      // Highest stage whose loads were started, -1 = none
+    int readyStage;          // Highest stage reported ready
+    std::chrono::steady_clock::time_point startTime;
+
+    void requestStage(int stage);
+    bool deliverTextures();
+
+public:
+    explicit AssetManifest(ModelCache& cache);
+
+    // Register a model for a stage; the handle is valid right away but the
+    // model only loads once the stage is requested
+    ModelHandle addModel(int stage, const char* filepath);
+
+    // Register a texture for a stage; onLoaded runs on the GL thread once it is loaded
+    void addTexture(int stage, const char* filepath, TextureCallback onLoaded);
+
+    // Load every asset of stages up to stage, blocking until they are ready
+    void loadStage(int stage);
+
+    // Once per frame: start the loads of the next stage and finish pending
+    // ones within the upload budget
+    void update(int currentStage, double budgetMs = ASSET_UPLOAD_BUDGET_MS);
+
+    // True once every asset of stages up to stage is loaded (or failed)
+    bool isStageReady(int stage) const;
+};
@@ -0,0 +1,23 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <glm/glm.hpp>
+
+// Bounding volumes of a model or submesh, for culling, LOD selection and collision
+struct Bounds {
+    float min[3];       // Axis-aligned box
+    float max[3];
+    float center[3];    // Bounding sphere
+    float radius;
+};
+
+// Bounds of count positions stored stride bytes apart. Each position is read
+// as four floats, so at least one more float must follow z (true for Vertex).
+Bounds computeBounds(const float* positions, size_t count, size_t stride);
+
+// Bounds of only the positions an index list refers to
+Bounds computeBounds(const float* positions, size_t stride, const uint32_t* indices, size_t indexCount);
+
+// World-space bounds of an object-space volume under transform (the box is
+// the AABB of the transformed box, the radius grows with the largest scale)
+Bounds transformBounds(const Bounds& bounds, const glm::mat4& transform);
@@ -0,0 +1,7 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+
+// 64-bit content hash used to detect a changed source file (cooked meshes and
+// textures) or a changed shader and driver (program binaries)
+uint64_t hashBytes(const void* data, size_t size);
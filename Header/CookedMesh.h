@@ -0,0 +1,72 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include "MappedFile.h"
+#include "ContentHash.h"
+#include "ObjParser.h"
+
+// Binary mesh cache written next to each OBJ (Models/Onion.obj -> Models/Onion.mesh).
+// Layout: CookedMeshHeader, interleaved Vertex or PackedVertex array, index array (16 or 32-bit),
+// Submesh table, MeshLod table. The vertex and index arrays are in their final GPU layout so a
+// mapped file can be handed straight to glBufferData.
+// Submesh::materialIndex is stored as 0 and resolved at load time.
+const uint32_t COOKED_MESH_MAGIC = 0x4853454D; // "MESH"
+const uint32_t COOKED_MESH_VERSION = 7;
+
+// CookedMeshHeader::vertexFormat
+const uint32_t VERTEX_FORMAT_FLOAT = 0;    // Vertex
+const uint32_t VERTEX_FORMAT_PACKED = 1;   // PackedVertex
+
+struct CookedMeshHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint64_t sourceHash;     // hashBytes() of the OBJ the mesh was cooked from
+    uint64_t sourceSize;
+    uint32_t vertexCount;
+    uint32_t vertexStride;   // sizeof(Vertex) or sizeof(PackedVertex) when the file was written
+    uint32_t indexCount;
+    uint32_t indexSize;      // 2 or 4 bytes
+    uint32_t submeshCount;
+    uint32_t vertexFormat;   // VERTEX_FORMAT_*
+    Bounds bounds;
+    uint64_t vertexOffset;   // Byte offsets from the start of the file
+    uint64_t indexOffset;
+    uint64_t submeshOffset;
+    char materialLibrary[64]; // mtllib of the source OBJ
+    float positionScale;     // Dequantization of packed positions
+    float positionOffset[3];
+    uint32_t lodCount;
+    uint32_t reserved;
+    uint64_t lodOffset;
+};
+
+// Path of the cooked mesh that belongs to an OBJ file
+std::string cookedMeshPath(const char* objPath);
+
+// Write mesh to path; indices are narrowed to 16-bit when the vertex count allows it
+// and mesh.packedVertices is stored instead of mesh.vertices when it is filled
+bool writeCookedMesh(const char* path, uint64_t sourceHash, uint64_t sourceSize, const MeshData& mesh);
+
+// Read-only view of a cooked mesh mapped from disk
+class CookedMesh {
+private:
+    MappedFile file;
+    const CookedMeshHeader* header;
+
+    bool validate(uint64_t sourceHash, uint64_t sourceSize, bool allowPacked) const;
+
+public:
+    CookedMesh() : header(nullptr) {}
+
+    // Map the cooked file and validate it against the source hash and size
+    // Returns false if it is missing, stale or malformed, or packed while
+    // allowPacked is false; a rejected file is not kept mapped
+    bool open(const char* path, uint64_t sourceHash, uint64_t sourceSize, bool allowPacked);
+
+    const CookedMeshHeader& info() const { return *header; }
+    const void* vertexData() const { return file.data() + header->vertexOffset; }
+    const void* indexData() const { return file.data() + header->indexOffset; }
+    const Submesh* submeshes() const { return reinterpret_cast<const Submesh*>(file.data() + header->submeshOffset); }
+    const MeshLod* lods() const { return reinterpret_cast<const MeshLod*>(file.data() + header->lodOffset); }
+};
@@ -0,0 +1,91 @@
+#pragma once
+#include <GL/glew.h>
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <vector>
+#include "MappedFile.h"
+#include "TextureCompression.h"
+
+// Binary texture cache written next to each image (Resources/start.jpg -> Resources/start.jpg.tex;
+// the extension stays because prijatno.jpg and prijatno.png both exist).
+// Layout: CookedTextureHeader, CookedTextureLevel table, then the pixel data of every mip
+// level from full size down to 1x1. Levels are already flipped (first row at the bottom),
+// tightly packed and in their final format (8-bit texels or compressed blocks), so they
+// upload straight from the mapped file.
+const uint32_t COOKED_TEXTURE_MAGIC = 0x58455443; // "CTEX"
+const uint32_t COOKED_TEXTURE_VERSION = 2;
+
+// Enough for a 32768x32768 texture
+const uint32_t MAX_TEXTURE_LEVELS = 16;
+
+struct CookedTextureLevel {
+    uint32_t width;
+    uint32_t height;
+    uint64_t offset;         // Bytes from the start of the pixel data
+    uint64_t size;
+};
+
+struct CookedTextureHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint64_t sourceHash;     // hashBytes() of the image the texture was cooked from
+    uint64_t sourceSize;
+    uint32_t width;
+    uint32_t height;
+    uint32_t channels;
+    uint32_t levelCount;
+    uint32_t internalFormat; // Sized or compressed format for glTexStorage2D (GL_RGBA8, GL_COMPRESSED_RGBA_BPTC_UNORM, ...)
+    uint32_t format;         // Pixel format of uncompressed level data (GL_RGBA, ...)
+    uint32_t type;           // GL_UNSIGNED_BYTE
+    uint32_t compression;    // TextureCompression of the level data
+    uint32_t requestedCompression; // TextureCookOptions the file was cooked with
+    uint32_t quality;
+    uint32_t supportedCompression; // Formats the cook was allowed to pick (1 << format)
+    uint64_t levelOffset;    // Byte offsets from the start of the file
+    uint64_t dataOffset;
+    uint64_t dataSize;       // Every level
+};
+
+// An image with its whole mip chain in memory, as the cooked file stores it
+struct TextureData {
+    uint32_t width = 0;
+    uint32_t height = 0;
+    uint32_t channels = 0;
+    uint32_t internalFormat = GL_RGBA8;
+    uint32_t format = GL_RGBA;
+    TextureCompression compression = TEXTURE_COMPRESSION_NONE;
+    std::vector<CookedTextureLevel> levels;
+    std::vector<unsigned char> pixels;
+};
+
+// Path of the cooked texture that belongs to an image file
+std::string cookedTexturePath(const char* imagePath);
+
+// Fill texture with a decoded 8-bit image and every mip level below it, each
+// the 2x2 box filter of the one above (what glGenerateMipmap computes)
+void buildMipChain(const unsigned char* image, uint32_t width, uint32_t height, uint32_t channels, TextureData& texture);
+
+bool writeCookedTexture(const char* path, uint64_t sourceHash, uint64_t sourceSize, const TextureData& texture,
+                        const TextureCookOptions& options, uint32_t supportedCompression);
+
+// Read-only view of a cooked texture mapped from disk
+class CookedTexture {
+private:
+    MappedFile file;
+    const CookedTextureHeader* header;
+
+    bool validate(uint64_t sourceHash, uint64_t sourceSize, const TextureCookOptions& options, uint32_t supportedCompression) const;
+
+public:
+    CookedTexture() : header(nullptr) {}
+
+    // Map the cooked file and validate it against the source hash and size and
+    // the options it has to be cooked with. Returns false if it is missing,
+    // stale, cooked differently or malformed; a rejected file is not kept mapped.
+    bool open(const char* path, uint64_t sourceHash, uint64_t sourceSize, const TextureCookOptions& options, uint32_t supportedCompression);
+
+    const CookedTextureHeader& info() const { return *header; }
+    const CookedTextureLevel* levels() const { return reinterpret_cast<const CookedTextureLevel*>(file.data() + header->levelOffset); }
+    const unsigned char* pixels() const { return reinterpret_cast<const unsigned char*>(file.data() + header->dataOffset); }
+};
@@ -0,0 +1,71 @@
+#pragma once
+#include <GL/glew.h>
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+#include <glm/glm.hpp>
+
+#include "Light.h"
+
+// Uniform buffer bindings of the per-frame blocks in basic.vert/basic.frag
+// (MaterialBlock uses MATERIAL_BLOCK_BINDING = 0)
+const GLuint FRAME_BLOCK_BINDING = 1;
+const GLuint LIGHT_BLOCK_BINDING = 2;
+
+// Passes drawn each frame, each with its own camera and light
+enum FramePass {
+    FRAME_PASS_SCENE,        // Perspective camera, scene light
+    FRAME_PASS_UI,           // Orthographic overlay, unlit
+    FRAME_PASS_COUNT
+};
+
+// FrameData block (std140)
+struct GpuFrameData {
+    float view[16];
+    float projection[16];
+    float viewProjection[16];
+    float viewPos[4];        // Camera position, w unused
+};
+
+// LightData block (std140)
+struct GpuLightData {
+    float position[4];       // w unused
+    float color[4];          // rgb, w unused
+    float strength;
+    int32_t enabled;         // Unread by the shaders; only SHADER_LIT variants light
+    float padding[2];
+};
+
+// Camera and light data that is the same for every draw of a pass, kept in one
+// uniform buffer with a FrameData and a LightData record per pass. upload()
+// writes every pass once per frame into an orphaned buffer; switching passes
+// only rebinds the two buffer ranges, so draws upload nothing but their own
+// model matrix and material.
+class FrameUniforms {
+private:
+    GpuFrameData frames[FRAME_PASS_COUNT];
+    GpuLightData lights[FRAME_PASS_COUNT];
+    GLuint ubo;
+    std::vector<unsigned char> staging;  // Every pass's records as laid out in the buffer
+    size_t lightOffset;      // Of a pass's LightData from the start of its record
+    size_t passStride;       // Both offsets honor GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT
+
+public:
+    FrameUniforms();
+    ~FrameUniforms();
+
+    FrameUniforms(const FrameUniforms&) = delete;
+    FrameUniforms& operator=(const FrameUniforms&) = delete;
+
+    void setCamera(FramePass pass, const glm::mat4& view, const glm::mat4& projection, const glm::vec3& viewPos);
+    void setLight(FramePass pass, const Light& light);
+
+    // Write every pass to the buffer (creating it on first use). Once per frame, GL thread only.
+    void upload();
+
+    // Point FRAME_BLOCK_BINDING and LIGHT_BLOCK_BINDING at a pass's records
+    void bind(FramePass pass) const;
+
+    // Delete the buffer (needs the GL context; the destructor does the same)
+    void destroy();
+};
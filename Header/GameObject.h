@@ -1,5 +1,6 @@
 #pragma once
 #include <string>
+#include "Model.h"
 
 struct GameObject {
     float x, y, z;           // 3D position (z added)
@@ -11,9 +12,9 @@ struct GameObject {
     bool isVisible;
     
     // 3D model support
-    bool is3DModel;          // If true, render using modelVAO instead of quad
-    unsigned int modelVAO;   // VAO handle for 3D model (0 means use quad)
-    std::string modelPath;   // Path to the model file for cache lookup
+    bool is3DModel;          // If true, render using model instead of quad
+    ModelHandle model;       // Handle from ModelCache::loadModel (INVALID_MODEL means use quad)
+    int materialIndex;       // MaterialLibrary slot for the whole model, -1 = the model's own materials tinted by r, g, b
     
     GameObject() : 
         x(0), y(0), z(0), 
@@ -21,5 +22,5 @@ struct GameObject {
         r(1), g(1), b(1), a(1), 
         rotateX(0), rotateY(0), rotateZ(0),
         textureId(0), useTexture(false), isVisible(true),
-        is3DModel(false), modelVAO(0), modelPath("") {}
+        is3DModel(false), model(INVALID_MODEL), materialIndex(-1) {}
 };
@@ -0,0 +1,68 @@
+#pragma once
+#include <GL/glew.h>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+// Initial buffer sizes of an arena; both double whenever they run out
+const uint64_t ARENA_INITIAL_VERTEX_BYTES = 2 * 1024 * 1024;
+const uint64_t ARENA_INITIAL_INDEX_BYTES = 1024 * 1024;
+
+// Where a model's geometry lives inside a GeometryArena
+struct GeometryAllocation {
+    uint64_t vertexOffset;   // Bytes into the arena's VBO (a multiple of the vertex stride)
+    uint64_t vertexBytes;
+    uint64_t indexOffset;    // Bytes into the arena's EBO
+    uint64_t indexBytes;
+    int32_t baseVertex;      // vertexOffset / stride, for glDrawElementsBaseVertex
+};
+
+// Vertex and index storage shared by every model with one vertex layout
+// (Vertex or PackedVertex): one VBO, one EBO and one VAO, sub-allocated
+// first-fit with freed ranges merged back. Models keep their own 0-based
+// indices and draw with glDrawElementsBaseVertex, so moving between models
+// needs no vertex state changes.
+class GeometryArena {
+private:
+    struct Range {
+        uint64_t offset;
+        uint64_t size;
+    };
+
+    bool packed;
+    unsigned int VAO, VBO, EBO;
+    uint64_t vertexCapacity, indexCapacity;   // Bytes
+    uint64_t vertexUsed, indexUsed;
+    std::vector<Range> freeVertices;          // Sorted by offset, never adjacent
+    std::vector<Range> freeIndices;
+
+    void create();
+    void setupVertexArray();
+    void grow(GLenum target, unsigned int& buffer, uint64_t& capacity, std::vector<Range>& freeRanges, uint64_t needed);
+
+    static bool allocateRange(std::vector<Range>& freeRanges, uint64_t size, uint64_t alignment, uint64_t& offset);
+    static void releaseRange(std::vector<Range>& freeRanges, uint64_t offset, uint64_t size);
+
+public:
+    explicit GeometryArena(bool packed);
+    ~GeometryArena();
+
+    GeometryArena(const GeometryArena&) = delete;
+    GeometryArena& operator=(const GeometryArena&) = delete;
+
+    // Copy a mesh into the arena (GL thread only). indexBytes must be a
+    // multiple of 4 when the indices are 32-bit.
+    GeometryAllocation allocate(const void* vertexData, uint32_t vertexCount, const void* indexData, uint64_t indexBytes);
+
+    // Return a model's ranges to the free lists
+    void release(const GeometryAllocation& allocation);
+
+    // Delete the GL objects and forget every allocation
+    void destroy();
+
+    unsigned int getVAO() const { return VAO; }
+    uint32_t stride() const;
+    uint64_t vertexBytesUsed() const { return vertexUsed; }
+    uint64_t indexBytesUsed() const { return indexUsed; }
+    uint64_t capacityBytes() const { return vertexCapacity + indexCapacity; }
+};
@@ -0,0 +1,34 @@
+#pragma once
+#include <cstddef>
+
+// Read-only memory mapping of a whole file.
+// Asset loaders scan the mapped bytes directly instead of copying them into
+// std::string lines, so a file is never duplicated in memory while parsing.
+class MappedFile {
+private:
+    const char* bytes;
+    size_t length;
+#ifdef _WIN32
+    void* fileHandle;
+    void* mappingHandle;
+#else
+    int fd;
+#endif
+
+public:
+    MappedFile();
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    // Map the file at filepath; returns false if it can't be opened or mapped
+    bool open(const char* filepath);
+
+    // Unmap the file (called automatically by the destructor)
+    void close();
+
+    const char* data() const { return bytes; }
+    size_t size() const { return length; }
+    bool isOpen() const { return bytes != nullptr; }
+};
@@ -0,0 +1,82 @@
+#pragma once
+#include <GL/glew.h>
+#include <vector>
+#include <string>
+#include <map>
+#include <cstdint>
+#include <cstddef>
+#include "TextureCache.h"
+
+// Material as parsed from an MTL file ("newmtl" block)
+struct MaterialDesc {
+    std::string name;
+    float diffuse[3];        // Kd
+    float specular[3];       // Ks
+    float shininess;         // Ns
+    float alpha;             // d
+    std::string diffuseMap;  // map_Kd, relative to the MTL file (empty if none)
+
+    MaterialDesc();
+};
+
+// Parse MTL text that is already in memory; appends one entry per newmtl
+void parseMTL(const char* data, size_t size, std::vector<MaterialDesc>& out);
+
+// One entry of the MaterialBlock uniform buffer (std140: two vec4s, 32-byte stride)
+struct GpuMaterial {
+    float diffuse[4];        // Kd, d
+    float specular[4];       // Ks, Ns
+};
+
+// Must match the array size of MaterialBlock in basic.frag
+const uint32_t MAX_MATERIALS = 256;
+const GLuint MATERIAL_BLOCK_BINDING = 0;
+
+// Table of every material in use. Slot 0 is the default material (white,
+// the shader's original specular settings) used for UI quads and meshes
+// without a material. The table lives in a single uniform buffer that draws
+// index with uMaterialIndex; only changed slots are re-uploaded.
+class MaterialLibrary {
+private:
+    std::vector<GpuMaterial> materials;
+    std::vector<std::string> diffuseMaps;
+    std::vector<TextureHandle> diffuseTextures;
+    TextureCache& textures;      // Where map_Kd textures are loaded
+    std::map<std::string, uint32_t> lookup;
+    GLuint ubo;
+    uint32_t dirtyBegin, dirtyEnd;   // Slots changed since the last upload
+
+    uint32_t addSlot(const std::string& key, const GpuMaterial& material, const std::string& diffuseMap);
+    void markDirty(uint32_t index);
+
+public:
+    explicit MaterialLibrary(TextureCache& textures);
+
+    MaterialLibrary(const MaterialLibrary&) = delete;
+    MaterialLibrary& operator=(const MaterialLibrary&) = delete;
+
+    // Register a parsed MTL material under "<mtlPath>:<name>"; returns its slot
+    // (the existing one if it was registered before)
+    uint32_t addMaterial(const std::string& mtlPath, const MaterialDesc& desc);
+
+    // Register a plain colored material (default specular) under name; returns
+    // its slot, the existing one if the name is already taken
+    uint32_t addColor(const std::string& name, float r, float g, float b, float a = 1.0f);
+
+    // Change the diffuse color of a slot, e.g. the patty while it cooks
+    void setDiffuse(uint32_t index, float r, float g, float b, float a = 1.0f);
+
+    // Slot of a registered material, or 0 (default) if unknown
+    uint32_t find(const std::string& mtlPath, const std::string& name) const;
+
+    const GpuMaterial& get(uint32_t index) const { return materials[index]; }
+    unsigned int diffuseTexture(uint32_t index) const { return textures.getId(diffuseTextures[index]); }
+    uint32_t count() const { return (uint32_t)materials.size(); }
+
+    // Create the uniform buffer on first use, request pending map_Kd textures and
+    // upload changed slots. GL thread only.
+    void upload();
+
+    // Delete the uniform buffer, release the textures and drop every material but the default
+    void clear();
+};
@@ -0,0 +1,40 @@
+#pragma once
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include "ObjParser.h"
+
+// Import-time triangle and vertex reordering for GPU efficiency.
+// All functions work on index ranges of a single submesh, so material
+// ranges stay contiguous; optimizeMesh runs the whole pipeline.
+
+// Vertex cache size the statistics are simulated with (FIFO, like the
+// post-transform caches of most desktop GPUs)
+const size_t VERTEX_CACHE_SIZE = 16;
+
+// How far optimizeOverdraw may raise ACMR while splitting into clusters
+const float OVERDRAW_THRESHOLD = 1.05f;
+
+struct VertexCacheStats {
+    float acmr;    // Average cache miss ratio: transformed vertices per triangle (0.5 - 3)
+    float atvr;    // Average transformed vertex ratio: transformed / unique vertices (1 is ideal)
+};
+
+// Simulate a FIFO post-transform cache over a triangle list
+VertexCacheStats analyzeVertexCache(const uint32_t* indices, size_t indexCount, size_t vertexCount,
+                                    size_t cacheSize = VERTEX_CACHE_SIZE);
+
+// Reorder triangles for vertex cache locality (Forsyth's linear-speed algorithm)
+void optimizeVertexCache(uint32_t* indices, size_t indexCount, size_t vertexCount);
+
+// Split cache-optimized triangles into clusters and order the clusters so
+// outward-facing ones come first, drawing likely occluders before what they
+// hide (Sander et al., Tipsify). ACMR rises by at most about threshold.
+void optimizeOverdraw(uint32_t* indices, size_t indexCount, const std::vector<Vertex>& vertices,
+                      float threshold = OVERDRAW_THRESHOLD);
+
+// Renumber vertices in order of first use so fetches walk the VBO linearly
+void optimizeVertexFetch(std::vector<Vertex>& vertices, std::vector<uint32_t>& indices);
+
+// Vertex cache, overdraw and vertex fetch optimization of every submesh
+void optimizeMesh(MeshData& mesh);
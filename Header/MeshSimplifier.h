@@ -0,0 +1,26 @@
+#pragma once
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include "ObjParser.h"
+
+// Quadric error mesh simplification (Garland & Heckbert) for LOD generation.
+// Edges are collapsed onto one of their endpoints, so every level indexes the
+// original vertex buffer and no new vertices are created. Vertices split on
+// UV or normal seams are collapsed together, each copy onto its neighbour.
+
+// LOD levels including the full-detail one
+const size_t MAX_LODS = 4;
+
+// Meshes with fewer triangles than this get no extra levels
+const size_t MIN_LOD_TRIANGLES = 256;
+
+// Simplify one triangle list towards targetIndexCount indices.
+// Returns the simplified list in out and the geometric error of the result
+// (an upper bound on the distance to the source surface, in object units).
+float simplifyTriangles(const std::vector<Vertex>& vertices, const uint32_t* indices, size_t indexCount,
+                        size_t targetIndexCount, std::vector<uint32_t>& out);
+
+// Append up to MAX_LODS - 1 coarser levels (each about half the triangles of
+// the previous one) to mesh.indices/submeshes and describe them in mesh.lods
+void generateLods(MeshData& mesh);
@@ -3,6 +3,12 @@
 #include <vector>
 #include <string>
 #include <map>
+#include <memory>
+#include <cstdint>
+#include "Material.h"
+#include "TextureCache.h"
+#include "Bounds.h"
+#include "GeometryArena.h"
 
 // Structure to hold vertex data for 3D models
 struct Vertex {
@@ -11,34 +17,205 @@ struct Vertex {
     float nx, ny, nz;     // Normal vectors
 };
 
+// Compact vertex layout (16 bytes) chosen per model when the mesh allows it
+// (see VertexPacking.h). Positions are snorm16 relative to the model's
+// positionOffset/positionScale, which the renderer folds into the model matrix.
+struct PackedVertex {
+    int16_t x, y, z, w;   // Position, snorm16 (w is padding)
+    uint32_t normal;      // GL_INT_2_10_10_10_REV, signed normalized
+    uint16_t u, v;        // Texture coordinates, half float
+};
+
+// Range of a model's index buffer that uses one material (one "usemtl" in the OBJ)
+struct Submesh {
+    uint32_t firstIndex;
+    uint32_t indexCount;
+    char material[64];       // Material name from the OBJ, empty if none was set
+    uint32_t materialIndex;  // Slot in the MaterialLibrary, resolved when the model is loaded
+    Bounds bounds;           // Object-space bounds of the vertices this range uses
+};
+
+// One level of detail: a run of submeshes drawing the model with fewer triangles.
+// Every level indexes the same vertex buffer.
+struct MeshLod {
+    uint32_t firstSubmesh;
+    uint32_t submeshCount;
+    float error;             // Geometric error in object units (0 for full detail)
+};
+
+// Where a model is in the load pipeline (see ModelCache::requestModel)
+enum ModelStatus {
+    MODEL_UNLOADED,     // Reserved handle, loading not started
+    MODEL_LOADING,      // Being parsed on a worker or waiting for its GL upload
+    MODEL_READY,
+    MODEL_FAILED,
+    MODEL_EVICTED       // Was ready; geometry dropped to stay within the memory budget
+};
+
 // Structure to hold a loaded 3D model
 struct Model {
-    unsigned int VAO;
-    unsigned int VBO;
-    unsigned int vertexCount;
+    ModelStatus status;
+    std::string path;            // Source OBJ
+    unsigned int VAO;            // Arena VAO, shared by every model with the same vertex layout
+    GeometryAllocation geometry; // Vertex and index ranges inside the arena
+    unsigned int vertexCount;    // Unique vertices in the VBO
+    unsigned int indexCount;     // Indices in the EBO (3 per triangle)
+    GLenum indexType;            // GL_UNSIGNED_SHORT or GL_UNSIGNED_INT
+    std::vector<Submesh> submeshes;  // Per-material index ranges of every LOD
+    std::vector<MeshLod> lods;       // Level 0 is full detail, then coarser levels
+    Bounds bounds;               // Object-space bounds of the whole model
+    bool packed;                 // VBO holds PackedVertex instead of Vertex
+    float positionScale;         // Packed positions: object = stored * scale + offset
+    float positionOffset[3];
+    uint64_t lastUsedFrame;      // ModelCache frame the model was last drawn (or loaded) in
     
-    Model() : VAO(0), VBO(0), vertexCount(0) {}
+    Model() : status(MODEL_READY), VAO(0), geometry(), vertexCount(0), indexCount(0), indexType(GL_UNSIGNED_INT),
+              bounds(),
+              packed(false), positionScale(1.0f), positionOffset{ 0.0f, 0.0f, 0.0f }, lastUsedFrame(0) {}
 };
 
+// Compact reference to a model in a ModelCache: index + 1 into its dense model
+// array, so resolving it per draw is a bounds check and an array access.
+// Handles stay valid until ModelCache::clear().
+typedef uint32_t ModelHandle;
+const ModelHandle INVALID_MODEL = 0;
+
+// Background loads that may wait for their GL upload at the same time
+const size_t MODEL_LOAD_QUEUE_CAPACITY = 64;
+
+// Memory held by a ModelCache (see ModelCache::getStats)
+struct ModelCacheStats {
+    size_t models;             // Handles, in any state
+    size_t residentModels;     // MODEL_READY
+    size_t loadingModels;      // MODEL_LOADING
+    size_t evictedModels;      // MODEL_EVICTED
+    size_t evictions;          // Evictions since the cache was created or cleared
+    uint64_t cpuBytes;         // Submesh and LOD tables of resident models
+    uint64_t gpuBytes;         // Vertex and index bytes of resident models
+    uint64_t packedBytesSaved; // Vertex bytes resident packed models save over the float layout
+    uint64_t gpuCapacityBytes; // Arena buffers, including their free ranges
+    uint64_t budgetBytes;      // 0 = unlimited
+};
+
+struct PendingMesh;
+template <typename T> class LockFreeQueue;
+typedef LockFreeQueue<std::unique_ptr<PendingMesh>> PendingMeshQueue;
+
 // Cache for loaded models to avoid loading the same model multiple times
 class ModelCache {
 private:
-    std::map<std::string, Model> models;
+    std::vector<Model> models;                   // Indexed by handle - 1
+    std::map<std::string, ModelHandle> handles;  // Path lookup, only used while loading
+    TextureCache textures;       // Every texture of the game, including map_Kd ones
+    MaterialLibrary materials;   // Materials of every loaded model's mtllib
+    bool vertexPacking;          // Allow the PackedVertex layout
+    Model placeholder;           // Unit cube drawn for models that are not loaded yet
+    GeometryArena floatGeometry; // Vertex data of every model, one arena per vertex layout
+    GeometryArena packedGeometry;
+    uint64_t memoryBudget;       // cpuBytes + gpuBytes allowed for resident models, 0 = unlimited
+    uint64_t residentBytes;      // cpuBytes + gpuBytes of resident models
+    uint64_t frameIndex;
+    size_t evictionCount;
+    
+    // Parsed meshes coming back from the workers. Shared with the tasks so a
+    // task finishing after the cache is gone still has somewhere to put its mesh.
+    std::shared_ptr<PendingMeshQueue> finished;
+    size_t loadsInFlight;
+    
+    void storeModel(ModelHandle handle, const Model& model);
+    static uint64_t cpuBytes(const Model& model);
+    static uint64_t gpuBytes(const Model& model);
+    Model createModelBuffers(const void* vertexData, uint32_t vertexCount, bool packed,
+                             const void* indexData, uint32_t indexCount, uint32_t indexSize);
+    Model uploadMesh(PendingMesh& pending);
     
 public:
-    ModelCache() {}
+    ModelCache();
     ~ModelCache();
     
-    // Load a model from file (or return cached version)
-    // Returns the VAO handle, or 0 if loading failed
-    unsigned int loadModel(const char* filepath);
+    // Load a model from file (or return cached version), blocking until it is ready
+    // Returns its handle, or INVALID_MODEL if loading failed
+    ModelHandle loadModel(const char* filepath);
+    
+    // Handle for a model without loading it yet (status MODEL_UNLOADED)
+    ModelHandle reserveModel(const char* filepath);
+    
+    // Start loading a reserved (or evicted) model in the background. The mesh is parsed
+    // on the worker pool and uploaded by pumpUploads; until then the model is MODEL_LOADING.
+    void requestModel(ModelHandle handle);
     
-    // Get a model by filepath (must be already loaded)
-    Model* getModel(const char* filepath);
+    // Create the GL buffers of background loads that finished parsing. Call once
+    // per frame on the GL thread; stops after budgetMs once one upload is done.
+    // Returns the number of models uploaded.
+    size_t pumpUploads(double budgetMs);
+    
+    // Background loads not uploaded yet
+    size_t pendingLoads() const { return loadsInFlight; }
+    
+    // Load several models at once: files are parsed in parallel on the shared
+    // worker pool while OpenGL buffers are created on the calling (GL) thread
+    void loadModels(const std::vector<std::string>& filepaths);
+    
+    // Handle of an already loaded model, INVALID_MODEL if it is not loaded
+    ModelHandle findModel(const char* filepath);
+    
+    // Get a model by handle (nullptr for INVALID_MODEL or a stale handle)
+    Model* getModel(ModelHandle handle) {
+        return (handle != INVALID_MODEL && handle <= models.size()) ? &models[handle - 1] : nullptr;
+    }
+    
+    bool isReady(ModelHandle handle) {
+        Model* model = getModel(handle);
+        return model && model->status == MODEL_READY;
+    }
+    
+    // Mark a model as drawn this frame, so it is the last one to be evicted
+    void touchModel(ModelHandle handle) {
+        Model* model = getModel(handle);
+        if (model) model->lastUsedFrame = frameIndex;
+    }
+    
+    // Limit the memory of resident models (0 = unlimited). Once endFrame finds the
+    // cache above it, the least recently drawn models are evicted; drawing an
+    // evicted model requests it again, which reads the cooked mesh.
+    void setMemoryBudget(uint64_t bytes) { memoryBudget = bytes; }
+    
+    // Call once per frame after drawing: evicts models over the budget
+    void endFrame();
+    
+    // Drop a model's geometry, keeping its handle, path and bounds (GL thread only)
+    void evictModel(ModelHandle handle);
+    
+    ModelCacheStats getStats() const;
+    
+    // Cube standing in for models that are still loading (created on first use,
+    // GL thread only)
+    const Model& getPlaceholder();
     
     // Check if a model is already loaded
     bool hasModel(const char* filepath);
     
-    // Clear all loaded models
+    // Object-space bounds of a loaded model (nullptr if the handle is invalid);
+    // per-submesh bounds are in getModel(handle)->submeshes
+    const Bounds* getBounds(ModelHandle handle) {
+        Model* model = getModel(handle);
+        return model ? &model->bounds : nullptr;
+    }
+    
+    // Use the packed vertex layout for models that allow it (default on).
+    // Affects models loaded afterwards.
+    void setVertexPacking(bool enabled) { vertexPacking = enabled; }
+    
+    // Material table shared by all models (submesh materialIndex points into it)
+    MaterialLibrary& getMaterials() { return materials; }
+    
+    // Texture cache shared by the materials and the rest of the game
+    TextureCache& getTextures() { return textures; }
+    
+    // Shared vertex/index storage of all models with the PackedVertex (or Vertex) layout
+    GeometryArena& getGeometry(bool packed) { return packed ? packedGeometry : floatGeometry; }
+    
+    // Clear all loaded models and their materials (invalidates every model handle;
+    // textures still referenced elsewhere stay loaded)
     void clear();
 };
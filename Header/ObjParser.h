@@ -0,0 +1,33 @@
+#pragma once
+#include <vector>
+#include <string>
+#include <cstddef>
+#include <cstdint>
+#include "Model.h"
+
+// CPU-side mesh produced by the OBJ parser, ready to be uploaded by ModelCache
+// Each unique v/vt/vn combination appears once in vertices; triangles index into it
+struct MeshData {
+    std::vector<Vertex> vertices;
+    std::vector<uint32_t> indices;
+    std::vector<Submesh> submeshes;
+    std::vector<MeshLod> lods;   // Filled by generateLods; submeshes of all levels are in submeshes
+    std::string materialLibrary; // File named by mtllib, relative to the OBJ (empty if none)
+    Bounds bounds;           // Object-space bounds of all vertices
+    
+    // Compact copy of vertices, filled by packVertices() when the packed layout is chosen
+    std::vector<PackedVertex> packedVertices;
+    float positionScale = 1.0f;
+    float positionOffset[3] = { 0.0f, 0.0f, 0.0f };
+};
+
+class ThreadPool;
+
+// Parse OBJ text that is already in memory (no copies of the input are made)
+// With a pool, large files are parsed in parallel chunks; the result is
+// identical to the serial parse. Returns false if the data contains no faces
+bool parseOBJ(const char* data, size_t size, MeshData& out, ThreadPool* pool = nullptr);
+
+// Print the parse time against the old getline/istringstream loader, then for
+// 1..hardware_concurrency threads (Kostur.exe --bench-obj <file>)
+void benchmarkOBJParser(const char* filepath);
@@ -0,0 +1,38 @@
+#pragma once
+#include <GL/glew.h>
+#include <string>
+#include <cstdint>
+
+// Linked programs saved with glGetProgramBinary so later runs skip compiling
+// and linking GLSL. One file per program in PROGRAM_CACHE_DIRECTORY, named by
+// its key. A binary only works on the driver that produced it, so the key
+// covers the GL vendor, renderer and version strings as well as the source
+// text; an update of either changes the key and the program is built again.
+const char* const PROGRAM_CACHE_DIRECTORY = "Shaders/Cache";
+const uint32_t PROGRAM_BINARY_MAGIC = 0x4E494253; // "SBIN"
+const uint32_t PROGRAM_BINARY_VERSION = 1;
+
+struct ProgramBinaryHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint64_t key;            // programBinaryKey() the binary was saved under
+    uint32_t binaryFormat;   // As returned by glGetProgramBinary
+    uint32_t size;           // Bytes of binary data after the header
+};
+
+// Key of a program built from these sources on the current context's driver
+uint64_t programBinaryKey(const std::string& vertexSource, const std::string& fragmentSource);
+
+std::string programBinaryPath(uint64_t key);
+
+// Load the cached binary into program (a new, empty program object). False if
+// binaries are unsupported, there is no valid file, or the driver rejects it;
+// the program must then be compiled as usual.
+bool loadProgramBinary(unsigned int program, uint64_t key);
+
+// Call before glLinkProgram on a program that will be saved
+void requestProgramBinary(unsigned int program);
+
+// Save a successfully linked program (nothing to do if the driver has no binary
+// formats). Returns false if the binary could not be retrieved or written.
+bool saveProgramBinary(unsigned int program, uint64_t key);
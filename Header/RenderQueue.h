@@ -0,0 +1,88 @@
+#pragma once
+#include <GL/glew.h>
+#include <vector>
+#include <cstdint>
+#include <glm/glm.hpp>
+
+#include "GameObject.h"
+#include "Camera.h"
+#include "Bounds.h"
+#include "ShaderVariants.h"
+
+class ModelCache;
+struct Model;
+
+// Largest on-screen error (in pixels) a coarser LOD may introduce
+const float LOD_PIXEL_ERROR = 1.0f;
+
+// Collects the 3D draws of a frame and issues them sorted by shader variant,
+// material, texture and VAO, so program, uniform and binding changes happen once
+// per group instead of once per object. Each model submesh is a separate draw with its own material.
+// Models with a LOD chain draw the coarsest level whose geometric error
+// projects to at most LOD_PIXEL_ERROR pixels at the object's distance.
+// Models (and submeshes) whose bounding sphere is outside the view frustum are skipped.
+// Models that are not loaded yet draw ModelCache's placeholder cube instead.
+// Blended draws (alpha < 1) keep their submission order after the opaque ones,
+// and nothing is reordered while depth testing is off (painter's order).
+class RenderQueue {
+private:
+    // Object as submitted; expanded into draws at flush time, once the
+    // camera and viewport are known
+    struct QueuedObject {
+        glm::mat4 transform;     // Object to world
+        ModelHandle model;       // INVALID_MODEL = 2D quad
+        int material;            // Own material slot, -1 = the model's materials
+        unsigned int texture;
+        int rounding;
+        glm::vec4 tint;
+    };
+
+    struct DrawItem {
+        uint64_t sortKey;
+        uint32_t order;          // Submission order, the tie-breaker
+        glm::mat4 model;
+        unsigned int VAO;        // 0 = 2D quad
+        GLenum indexType;
+        uint64_t indexOffset;    // Bytes into the arena's element buffer
+        int32_t baseVertex;
+        uint32_t indexCount;
+        uint32_t material;
+        unsigned int texture;
+        int rounding;
+        glm::vec4 tint;          // Object color for objects without a material of their own
+        uint32_t features;       // ShaderFeature mask of the variant that draws it
+        bool blended;
+    };
+
+    std::vector<QueuedObject> objects;
+    std::vector<DrawItem> items;
+    size_t lastTriangleCount;
+    size_t lastCulledCount;
+
+    // LOD level of a model with the given world-space bounds, for the camera
+    // and a viewport height in pixels
+    static size_t selectLod(const Model& model, const Bounds& worldBounds, const Camera& camera, float viewportHeight);
+
+public:
+    // Queue obj (or its quad); its submeshes are expanded at flush time. Objects
+    // with materialIndex >= 0 use that slot for all submeshes, others use their
+    // MTL materials.
+    void submit(const GameObject& obj, int roundingMode = 0);
+
+    // Draw and clear everything submitted. Each draw uses the variant of shaders with
+    // passFeatures plus SHADER_TEXTURED/SHADER_ROUNDED if it has a texture or a
+    // rounding mode, so untextured, square draws run no sampling or discard code.
+    // The shaders take view and projection from the bound FrameData range, which
+    // must be the same camera (FRAME_PASS_SCENE).
+    void flush(ShaderVariants& shaders, uint32_t passFeatures, unsigned int quadVAO, Camera& camera, float aspectRatio, ModelCache& cache);
+
+    RenderQueue() : lastTriangleCount(0), lastCulledCount(0) {}
+
+    size_t size() const { return objects.size(); }
+
+    // Triangles drawn by the last flush, after LOD selection
+    size_t trianglesDrawn() const { return lastTriangleCount; }
+
+    // Models skipped by the last flush because they were outside the view
+    size_t objectsCulled() const { return lastCulledCount; }
+};
@@ -0,0 +1,64 @@
+#pragma once
+#include <GL/glew.h>
+#include <string>
+#include <vector>
+#include <cstdint>
+
+#include "ShaderProgram.h"
+
+// Identifies a program submitted to a ShaderBuildQueue; tickets are not reused
+typedef uint32_t ShaderBuildTicket;
+const ShaderBuildTicket INVALID_SHADER_BUILD = UINT32_MAX;
+
+// Programs compiled and linked without waiting for them. submit() hands both
+// stages and the link to the driver and returns; compile and link status are
+// only asked for once a build is known to be done, because asking makes the
+// driver finish it on the spot. With GL_KHR_parallel_shader_compile the driver
+// compiles on its own threads and poll() checks GL_COMPLETION_STATUS_KHR;
+// without it poll() finishes one build per call, so a frame waits for at most
+// one program. Programs with a cached binary (ProgramBinaryCache) are done on
+// submit. GL thread only.
+class ShaderBuildQueue {
+private:
+    struct Build {
+        unsigned int program;
+        unsigned int vertexShader;   // Deleted (0) once the build is done
+        unsigned int fragmentShader;
+        uint64_t binaryKey;
+        bool done;
+        ShaderProgram result;        // Valid once done, until taken
+    };
+
+    std::vector<Build> builds;       // Indexed by ticket
+    size_t pendingCount;
+
+    void finish(Build& build);
+
+public:
+    ShaderBuildQueue() : pendingCount(0) {}
+    ~ShaderBuildQueue();
+
+    ShaderBuildQueue(const ShaderBuildQueue&) = delete;
+    ShaderBuildQueue& operator=(const ShaderBuildQueue&) = delete;
+
+    // Start compiling and linking a program from its sources
+    ShaderBuildTicket submit(const std::string& vertexCode, const std::string& fragmentCode);
+
+    // Finish the builds the driver is done with, without blocking on the
+    // others; true once nothing is pending
+    bool poll();
+
+    bool isReady(ShaderBuildTicket ticket) const { return builds[ticket].done; }
+
+    // The build's program, finishing it first if needed (which blocks). The
+    // caller owns it afterwards.
+    ShaderProgram take(ShaderBuildTicket ticket);
+
+    size_t pending() const { return pendingCount; }
+
+    // Delete every unfinished build and untaken program (needs the GL context)
+    void clear();
+
+    // Whether the driver compiles on threads of its own (GL_KHR_parallel_shader_compile)
+    static bool parallelCompileAvailable();
+};
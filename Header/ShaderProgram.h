@@ -0,0 +1,77 @@
+#pragma once
+#include <GL/glew.h>
+#include <string>
+#include <unordered_map>
+#include <cstdint>
+#include <glm/glm.hpp>
+
+// Uniforms the renderer sets per draw, each with a fixed slot so draws index an
+// array instead of looking names up. UNIFORM_SLOT_NAMES holds the GLSL names.
+// Camera and light data are uniform blocks instead (see FrameUniforms).
+enum UniformSlot {
+    UNIFORM_MODEL,
+    UNIFORM_COLOR,
+    UNIFORM_TEXTURE,
+    UNIFORM_ROUNDING,
+    UNIFORM_MATERIAL_INDEX,
+    UNIFORM_SLOT_COUNT
+};
+
+extern const char* const UNIFORM_SLOT_NAMES[UNIFORM_SLOT_COUNT];
+
+// A linked GL program with its active uniforms enumerated once at link time
+// (glGetActiveUniform). Slot uniforms keep a copy of the value last set, and a
+// setter whose value did not change makes no GL call. Uniforms the program does
+// not use (optimized out, or absent) are ignored. Setters write to the current
+// program, so call use() first; values stay valid across other programs since
+// GL keeps them per program.
+class ShaderProgram {
+private:
+    struct Uniform {
+        GLint location;          // -1 if the program has no such active uniform
+        GLenum type;
+        uint32_t size;           // Words in value, 0 until set once
+        uint32_t value[16];      // Last value set, as raw words
+    };
+
+    unsigned int id;
+    Uniform slots[UNIFORM_SLOT_COUNT];
+    std::unordered_map<std::string, GLint> locations;  // Every active uniform by name ("[0]" stripped from arrays)
+
+    void reflect();
+    bool changed(UniformSlot slot, const void* value, uint32_t words);
+
+public:
+    ShaderProgram() : id(0) { invalidate(); }
+
+    // Take ownership of a linked program and enumerate its uniforms
+    explicit ShaderProgram(unsigned int program);
+    ~ShaderProgram();
+
+    ShaderProgram(const ShaderProgram&) = delete;
+    ShaderProgram& operator=(const ShaderProgram&) = delete;
+    ShaderProgram(ShaderProgram&& other) noexcept;
+    ShaderProgram& operator=(ShaderProgram&& other) noexcept;
+
+    unsigned int getId() const { return id; }
+    bool isValid() const { return id != 0; }
+
+    void use() const { glUseProgram(id); }
+
+    // Location of a slot or of any active uniform by name (-1 if it is not active)
+    GLint location(UniformSlot slot) const { return slots[slot].location; }
+    GLint location(const char* name) const;
+    bool has(UniformSlot slot) const { return slots[slot].location >= 0; }
+
+    void set(UniformSlot slot, int value);
+    void set(UniformSlot slot, float value);
+    void set(UniformSlot slot, const glm::vec3& value);
+    void set(UniformSlot slot, const glm::vec4& value);
+    void set(UniformSlot slot, const glm::mat4& value);
+
+    // Forget the shadowed values, so the next set() of every slot uploads
+    void invalidate();
+
+    // Delete the program (needs the GL context; the destructor does the same)
+    void destroy();
+};
@@ -0,0 +1,78 @@
+#pragma once
+#include <GL/glew.h>
+#include <string>
+#include <vector>
+#include <utility>
+#include <cstdint>
+
+#include "ShaderProgram.h"
+#include "ShaderBuildQueue.h"
+
+// Features a variant of basic.vert/basic.frag is compiled with. Each bit is a
+// #define (SHADER_FEATURE_DEFINES) added to both stages, so the shader picks its
+// code paths at compile time instead of branching on uniforms per fragment.
+enum ShaderFeature : uint32_t {
+    SHADER_TEXTURED = 1u << 0,   // Sample uTexture; uColor alone without
+    SHADER_LIT      = 1u << 1,   // Phong lighting from LightData; flat ambient without
+    SHADER_ROUNDED  = 1u << 2,   // Discard the corners uRounding selects; never discards without
+};
+
+const uint32_t SHADER_FEATURE_COUNT = 3;
+const uint32_t SHADER_VARIANT_COUNT = 1u << SHADER_FEATURE_COUNT;
+
+extern const char* const SHADER_FEATURE_DEFINES[SHADER_FEATURE_COUNT];
+
+// Features of a draw with the given texture and rounding mode, on top of the
+// pass's own (SHADER_LIT while its light is on)
+inline uint32_t shaderFeatures(uint32_t passFeatures, unsigned int texture, int rounding) {
+    return passFeatures | (texture != 0 ? SHADER_TEXTURED : 0u) | (rounding != 0 ? SHADER_ROUNDED : 0u);
+}
+
+// source with a #define per feature in features, right after its #version line
+std::string shaderVariantSource(const std::string& source, uint32_t features);
+
+// Every permutation of one vertex/fragment shader pair, keyed by a ShaderFeature
+// mask. Variants build on a ShaderBuildQueue (or load from the program binary
+// cache, whose key covers the defines): request() starts a build, poll() adopts
+// the finished ones, and get() waits for a variant if it is not ready yet. Each
+// gets the uniform block bindings registered with setBlockBinding. GL thread only.
+class ShaderVariants {
+private:
+    std::string vertexSource;
+    std::string fragmentSource;
+    ShaderProgram programs[SHADER_VARIANT_COUNT];
+    ShaderBuildTicket tickets[SHADER_VARIANT_COUNT];   // INVALID_SHADER_BUILD unless building
+    ShaderBuildQueue queue;
+    std::vector<std::pair<std::string, GLuint>> blockBindings;
+
+    void adopt(uint32_t features);
+
+public:
+    ShaderVariants();
+
+    ShaderVariants(const ShaderVariants&) = delete;
+    ShaderVariants& operator=(const ShaderVariants&) = delete;
+
+    // Read both stages; false if either file is missing or empty
+    bool load(const char* vsPath, const char* fsPath);
+
+    // Bind the named uniform block of every variant (built or not) to binding
+    void setBlockBinding(const char* block, GLuint binding);
+
+    // Start building a variant (or every variant) unless it is built or building
+    void request(uint32_t features);
+    void requestAll();
+
+    // Once per frame: take over the variants whose build finished; true once
+    // none is building
+    bool poll();
+
+    // The variant with exactly these features, building it (and waiting) if needed
+    ShaderProgram& get(uint32_t features);
+
+    bool isBuilt(uint32_t features) const { return programs[features].isValid(); }
+    size_t building() const { return queue.pending(); }
+
+    // Delete every variant, built or building (needs the GL context)
+    void destroy();
+};
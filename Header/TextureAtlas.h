@@ -0,0 +1,61 @@
+#pragma once
+#include <GL/glew.h>
+#include <vector>
+#include <string>
+#include <unordered_map>
+#include <cstdint>
+
+// Name of the opaque white region every atlas contains, for untextured quads
+const char* const ATLAS_WHITE_REGION = "white";
+
+// Mip levels of an atlas. Images sit at multiples of 2^(levels - 1) texels, so
+// every level of an image starts on a whole texel of the atlas level.
+const uint32_t ATLAS_MIP_LEVELS = 4;
+
+// An image packed into an atlas. UVs cover the image without its padding, with
+// v = 0 at the bottom like every texture here.
+struct AtlasRegion {
+    std::string name;            // Path the image was added with
+    uint32_t x, y;               // Texels in level 0
+    uint32_t width, height;
+    float u0, v0, u1, v1;
+};
+
+// Several small images packed into one RGBA texture, so everything drawn from
+// them can share one bind (see UIBatch). Images are packed on shelves sorted by
+// height, each surrounded by padding that repeats its edge texels so filtering
+// never reaches a neighbour. Mip levels are built per image before they are
+// placed, for the same reason.
+class TextureAtlas {
+private:
+    std::vector<AtlasRegion> regions;
+    std::unordered_map<std::string, size_t> lookup;
+    unsigned int id;
+    uint32_t width, height;
+
+public:
+    TextureAtlas() : id(0), width(0), height(0) {}
+    ~TextureAtlas();
+
+    TextureAtlas(const TextureAtlas&) = delete;
+    TextureAtlas& operator=(const TextureAtlas&) = delete;
+
+    // Decode and pack the images into a new texture of at most maxSize x maxSize.
+    // Images that fail to decode are reported and left out. Returns false if the
+    // images do not fit; the atlas is empty then.
+    bool build(const std::vector<std::string>& paths, uint32_t padding = 8, uint32_t maxSize = 4096);
+
+    // Region of an image by the path it was added with (nullptr if it is not in the atlas)
+    const AtlasRegion* find(const char* name) const;
+
+    // The ATLAS_WHITE_REGION region
+    const AtlasRegion* white() const { return find(ATLAS_WHITE_REGION); }
+
+    unsigned int getId() const { return id; }
+    uint32_t getWidth() const { return width; }
+    uint32_t getHeight() const { return height; }
+    size_t size() const { return regions.size(); }
+
+    // Delete the texture and forget every region
+    void clear();
+};
@@ -0,0 +1,174 @@
+#pragma once
+#include <GL/glew.h>
+#include <vector>
+#include <string>
+#include <unordered_map>
+#include <memory>
+#include <cstdint>
+#include "TextureCompression.h"
+
+// Compact reference to a texture in a TextureCache: index + 1 into its texture
+// array. Handles stay valid until TextureCache::clear().
+typedef uint32_t TextureHandle;
+const TextureHandle INVALID_TEXTURE = 0;
+
+// Where a texture is in the load pipeline (see TextureCache::request)
+enum TextureStatus {
+    TEXTURE_UNLOADED,   // Not resident: never loaded, or purged
+    TEXTURE_LOADING,    // Preparing on a worker, or uploaded and waiting for its fence
+    TEXTURE_READY,
+    TEXTURE_FAILED      // The image could not be loaded; not retried until clear()
+};
+
+// Pixel buffers that background uploads cycle through. A prepared image waits
+// while the copy out of the next buffer is still running.
+const size_t TEXTURE_UPLOAD_BUFFERS = 4;
+
+// Background loads that may wait for their upload at the same time
+const size_t TEXTURE_LOAD_QUEUE_CAPACITY = 64;
+
+// A cached texture and what is known about it without asking OpenGL
+struct Texture {
+    TextureStatus status;
+    std::string path;
+    unsigned int id;         // GL texture name, 0 until uploaded
+    int width, height;
+    int channels;            // As decoded: 1 = red, 2 = red/green, 3 = RGB, 4 = RGBA
+    GLenum format;           // GL_RED, GL_RG, GL_RGB or GL_RGBA
+    GLenum internalFormat;   // Sized or compressed format the storage was allocated with
+    TextureCompression compression;
+    uint32_t mipLevels;
+    uint64_t gpuBytes;       // Every mip level
+    uint32_t refCount;
+
+    Texture() : status(TEXTURE_UNLOADED), id(0), width(0), height(0), channels(0), format(GL_RGB), internalFormat(GL_RGB8),
+                compression(TEXTURE_COMPRESSION_NONE), mipLevels(0), gpuBytes(0), refCount(0) {}
+};
+
+struct TextureCacheStats {
+    size_t textures;         // Handles, in any state
+    size_t residentTextures;
+    size_t loadingTextures;
+    size_t referencedTextures;
+    uint64_t gpuBytes;       // Resident textures including mip levels
+    uint64_t stagingBytes;   // Pixel buffers used for uploads
+};
+
+struct PendingImage;
+template <typename T> class LockFreeQueue;
+typedef LockFreeQueue<std::unique_ptr<PendingImage>> PendingImageQueue;
+
+// Cache for loaded textures so every image is decoded and uploaded once.
+// Textures are reference counted; one that is no longer referenced stays
+// resident (acquiring it again is a hash lookup) until purgeUnused() or clear().
+// Images are loaded from their cooked texture (see CookedTexture.h) with every
+// mip level prebuilt; an image without an up-to-date one is decoded once and
+// cooked, block compressed as its cook options ask when the driver can sample
+// the format. Images requested in the background are prepared on the worker pool
+// and copied into their texture from a pixel buffer object; a 1x1 white texture
+// stands in until the copy's fence signals. GL thread only.
+class TextureCache {
+private:
+    struct UploadBuffer {
+        unsigned int pbo;
+        uint64_t size;           // Bytes allocated
+        GLsync fence;            // Set until the texture copied from it is complete
+        TextureHandle handle;
+    };
+
+    std::vector<Texture> textures;                          // Indexed by handle - 1
+    std::unordered_map<std::string, TextureHandle> handles;
+    unsigned int fallback;
+
+    // Cook options by path prefix; "" is the default
+    std::vector<std::pair<std::string, TextureCookOptions>> cookOptions;
+    uint32_t supportedCompression;  // Mask of 1 << format, ~0u until queried
+
+    // Prepared images coming back from the workers (shared with the tasks, like
+    // ModelCache's queue) and the one waiting for a free upload buffer
+    std::shared_ptr<PendingImageQueue> finished;
+    std::unique_ptr<PendingImage> waiting;
+    size_t loadsInFlight;
+    UploadBuffer uploadBuffers[TEXTURE_UPLOAD_BUFFERS];
+    size_t nextUploadBuffer;
+
+    TextureHandle reserveTexture(const char* filepath);
+    void loadTexture(Texture& texture);
+    void deleteTexture(Texture& texture);
+    void createTexture(Texture& texture, const PendingImage& image, const unsigned char* pixels);
+    bool uploadImage(PendingImage& image);
+    void pollFences();
+    uint32_t getSupportedCompression();
+
+public:
+    TextureCache();
+    ~TextureCache();
+
+    TextureCache(const TextureCache&) = delete;
+    TextureCache& operator=(const TextureCache&) = delete;
+
+    // Load a texture (or reuse the cached one) and add a reference to it,
+    // blocking until it is ready. The handle is valid even if loading failed;
+    // its id is 0 then.
+    TextureHandle acquire(const char* filepath);
+
+    // acquire() for callers that only keep the GL texture name (0 on failure)
+    unsigned int load(const char* filepath) { return getId(acquire(filepath)); }
+
+    // Add a reference and start loading in the background if the texture is not
+    // resident; until it is TEXTURE_READY, getId() returns the fallback texture
+    TextureHandle request(const char* filepath);
+
+    // Upload images the workers finished preparing and mark textures whose copy
+    // completed as ready. Call once per frame on the GL thread; stops after
+    // budgetMs once one upload is done. Returns the number of uploads started.
+    size_t pumpUploads(double budgetMs);
+
+    // Background loads not ready yet
+    size_t pendingLoads() const;
+
+    // Drop a reference; the texture stays cached until purgeUnused()
+    void release(TextureHandle handle);
+
+    // Handle of an already cached texture, INVALID_TEXTURE if there is none
+    TextureHandle findTexture(const char* filepath) const;
+
+    // Get a texture by handle (nullptr for INVALID_TEXTURE or a stale handle)
+    const Texture* getTexture(TextureHandle handle) const {
+        return (handle != INVALID_TEXTURE && handle <= textures.size()) ? &textures[handle - 1] : nullptr;
+    }
+
+    // Texture to bind for a handle: its own once ready, the fallback while it
+    // loads, 0 if it failed or is not resident
+    unsigned int getId(TextureHandle handle) const {
+        const Texture* texture = getTexture(handle);
+        if (!texture) return 0;
+        if (texture->status == TEXTURE_READY) return texture->id;
+        return texture->status == TEXTURE_LOADING ? fallback : 0;
+    }
+
+    // 1x1 white texture (created on first use)
+    unsigned int getFallback();
+
+    // Cook images whose path starts with pathPrefix with these options; the
+    // longest matching prefix wins. Textures already resident keep their format
+    // until they are loaded again.
+    void setCookOptions(const char* pathPrefix, const TextureCookOptions& options);
+    const TextureCookOptions& getCookOptions(const char* filepath) const;
+
+    // Delete every texture without references; their handles stay valid and
+    // load again on the next acquire(). Returns the bytes freed.
+    uint64_t purgeUnused();
+
+    TextureCacheStats getStats() const;
+
+    // Delete all textures (invalidates every handle)
+    void clear();
+};
+
+// Write the cooked texture of an image unless an up-to-date one exists (no
+// OpenGL needed). Without a context the formats the driver samples are unknown,
+// so by default every block format is allowed. Returns false if the image could
+// not be loaded or written.
+bool cookTexture(const char* imagePath, const TextureCookOptions& options = TextureCookOptions(),
+                 uint32_t supportedCompression = TEXTURE_COMPRESSION_BLOCK_FORMATS);
@@ -0,0 +1,46 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+
+struct TextureData;
+
+// Block compression a cooked texture can store. Every format encodes 4x4 texel blocks.
+enum TextureCompression : uint32_t {
+    TEXTURE_COMPRESSION_NONE,
+    TEXTURE_COMPRESSION_BC1,    // RGB, 8 bytes per block (alpha is dropped)
+    TEXTURE_COMPRESSION_BC3,    // RGBA, 16 bytes per block: BC1 color plus interpolated alpha
+    TEXTURE_COMPRESSION_BC7,    // RGBA, 16 bytes per block, best quality (mode 6 only)
+    TEXTURE_COMPRESSION_AUTO    // BC1 for opaque images, BC7 (or BC3 without BPTC) otherwise
+};
+
+// Bit (1 << format) of every block format, for masks of what the driver can sample
+const uint32_t TEXTURE_COMPRESSION_BLOCK_FORMATS =
+    (1u << TEXTURE_COMPRESSION_BC1) | (1u << TEXTURE_COMPRESSION_BC3) | (1u << TEXTURE_COMPRESSION_BC7);
+
+// How an image is cooked, chosen per texture (see TextureCache::setCookOptions)
+struct TextureCookOptions {
+    TextureCompression compression = TEXTURE_COMPRESSION_NONE;
+    uint32_t quality = 1;    // 0 = endpoints from the block's bounding box, 1 = principal axis plus a least-squares refit
+};
+
+// Bytes of one block and of a whole width x height level
+uint32_t compressedBlockBytes(TextureCompression format);
+uint64_t compressedLevelSize(TextureCompression format, uint32_t width, uint32_t height);
+
+// Encode one block of 16 RGBA texels (row by row)
+void encodeBC1Block(const uint8_t texels[64], uint32_t quality, uint8_t out[8]);
+void encodeBC3Block(const uint8_t texels[64], uint32_t quality, uint8_t out[16]);
+void encodeBC7Block(const uint8_t texels[64], uint32_t quality, uint8_t out[16]);
+
+// The format an image is actually stored in: AUTO resolved by the image's alpha,
+// and NONE for formats outside supported (a mask of 1 << format) or images with
+// fewer than three channels
+TextureCompression resolveCompression(TextureCompression requested, const TextureData& texture, uint32_t supported);
+
+// Formats resolveCompression may pick for requested (1 << format): none for
+// NONE, every block format for AUTO, otherwise the requested one
+uint32_t compressionCandidates(TextureCompression requested);
+
+// Replace every level of an uncompressed 8-bit texture with its blocks, encoded
+// on the shared worker pool
+void compressTexture(TextureData& texture, TextureCompression format, uint32_t quality);
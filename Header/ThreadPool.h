@@ -0,0 +1,40 @@
+#pragma once
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+
+// Fixed set of worker threads for CPU-side asset work (parsing, decoding).
+// Tasks must never touch OpenGL - only the thread owning the context may.
+class ThreadPool {
+private:
+    std::vector<std::thread> workers;
+    std::deque<std::function<void()>> tasks;
+    std::mutex mutex;
+    std::condition_variable wake;
+    bool stopping;
+
+    void workerLoop();
+
+public:
+    explicit ThreadPool(unsigned int threadCount);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    // Queue a task for any worker
+    void submit(std::function<void()> task);
+
+    // Run fn(0..count-1) across the workers and the calling thread, returning
+    // when all are done. The caller claims work too, so this is safe to use
+    // from inside a task even when every worker is busy.
+    void parallelFor(size_t count, const std::function<void(size_t)>& fn);
+
+    unsigned int size() const { return (unsigned int)workers.size(); }
+
+    // Pool shared by all loaders, one worker per core except the main thread's
+    static ThreadPool& shared();
+};
@@ -0,0 +1,42 @@
+#pragma once
+#include <GL/glew.h>
+#include <vector>
+
+#include "GameObject.h"
+#include "TextureAtlas.h"
+#include "ShaderVariants.h"
+
+// Collects the 2D overlay quads of a frame and draws them with one call, all
+// sampling the same TextureAtlas. Each quad carries its region's UVs and the
+// object's color as vertex data; untextured quads use the atlas's white region.
+// Quads are drawn in the order they were added (painter's order).
+class UIBatch {
+private:
+    struct UIVertex {
+        float x, y, z;
+        float u, v;
+        float r, g, b, a;
+    };
+
+    std::vector<UIVertex> vertices;
+    unsigned int VAO, VBO;
+    size_t capacity;             // Vertices the buffer holds
+
+public:
+    // Creates the vertex array; needs a current GL context
+    UIBatch();
+    ~UIBatch();
+
+    UIBatch(const UIBatch&) = delete;
+    UIBatch& operator=(const UIBatch&) = delete;
+
+    // Queue obj's quad (position and size only; UI quads are not rotated) showing region
+    void add(const GameObject& obj, const AtlasRegion& region);
+
+    // Draw and clear everything added with the SHADER_TEXTURED variant and the
+    // atlas texture bound. The camera comes from the bound FrameData range
+    // (FRAME_PASS_UI).
+    void flush(ShaderVariants& shaders, const TextureAtlas& atlas);
+
+    size_t size() const { return vertices.size() / 6; }
+};
@@ -10,20 +10,12 @@
 #include "Camera.h"
 #include "Light.h"
 
-// Forward declarations
-class ModelCache;
-
 int endProgram(std::string message);
-unsigned int createShader(const char* vsSource, const char* fsSource);
-unsigned loadImageToTexture(const char* filePath);
-GLFWcursor* loadImageToCursor(const char* filePath);
-
-// 3D model loading
-unsigned int loadOBJModel(const char* filepath, ModelCache& cache);
+// Whole file as text; empty if it cannot be read
+std::string readShaderFile(const char* source);
 
-// Render a 3D model or 2D quad based on GameObject settings
-void RenderObject3D(unsigned int shader, unsigned int quadVAO, GameObject& obj, 
-                    Camera& camera, float aspectRatio, ModelCache& cache, int roundingMode = 0);
-
-// Pass light uniforms to shader
-void setLightUniforms(unsigned int shader, const Light& light, const Camera& camera);
\ No newline at end of file
+// Decode an image with its first row at the bottom, as OpenGL expects; nullptr
+// on failure. Touches no OpenGL state, so workers may call it. Free with freeImage.
+unsigned char* decodeImage(const char* filePath, int* width, int* height, int* channels);
+void freeImage(unsigned char* pixels);
+GLFWcursor* loadImageToCursor(const char* filePath);
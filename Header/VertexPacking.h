@@ -0,0 +1,18 @@
+#pragma once
+#include <cstdint>
+#include "ObjParser.h"
+
+// Half floats keep a step of 1/512 or finer for texture coordinates up to this
+// magnitude; meshes with larger (tiling) UVs stay on the float layout
+const float MAX_PACKED_TEXCOORD = 4.0f;
+
+// IEEE 754 binary16 with round-to-nearest-even
+uint16_t floatToHalf(float value);
+
+// True if the mesh survives packing without visible loss
+bool canPackVertices(const MeshData& mesh);
+
+// Fill mesh.packedVertices, positionScale and positionOffset from mesh.vertices.
+// One uniform scale is used for all axes so that normals stay correct when it
+// is folded into the model matrix.
+void packVertices(MeshData& mesh);
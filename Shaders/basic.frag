@@ -1,28 +1,51 @@
 #version 330 core
 
 // OpenGL 3.3 Core Profile compatible
+// Compiled once per feature combination (ShaderVariants): TEXTURED, LIT and
+// ROUNDED are #defined after the version line instead of tested per fragment
 in vec2 TexCoord;
 in vec3 Normal;
 in vec3 FragPos;
+in vec4 VertexColor;
 
 out vec4 FragColor;
 
 uniform sampler2D uTexture;
 uniform vec4 uColor; 
-uniform int uUseTexture; 
 
-// 0 = Nema zaobljenja, 1 = Dole (BunBot), 2 = Gore (BunTop)
+// 1 = Dole (BunBot), 2 = Gore (BunTop); 0 (nema zaobljenja) uses a variant without ROUNDED
 uniform int uRounding; 
 
-// Phong lighting uniforms
-uniform vec3 uLightPos;       // Light position in world space
-uniform vec3 uLightColor;     // Light color
-uniform float uLightStrength; // Light intensity/strength
-uniform bool uLightEnabled;   // Toggle light on/off
-uniform vec3 uViewPos;        // Camera position for specular calculation
+// Camera of the current pass (same block as in basic.vert)
+layout(std140) uniform FrameData {
+    mat4 uView;
+    mat4 uProjection;
+    mat4 uViewProjection;
+    vec4 uViewPos;            // Camera position for specular calculation
+};
+
+// Phong light of the current pass, written once per frame (FrameUniforms, std140)
+layout(std140) uniform LightData {
+    vec4 uLightPos;           // Light position in world space
+    vec4 uLightColor;         // Light color
+    float uLightStrength;     // Light intensity/strength
+    int uLightEnabled;        // Unused; the light toggle picks a variant without LIT
+};
+
+// Material table shared by all draws (MaterialLibrary, std140)
+// Slot 0 is the default: white diffuse, specular 0.5 with shininess 32
+struct Material {
+    vec4 diffuse;   // Kd, alpha (d)
+    vec4 specular;  // Ks, shininess (Ns)
+};
+layout(std140) uniform MaterialBlock {
+    Material uMaterials[256];
+};
+uniform int uMaterialIndex;
 
 void main()
 {
+#ifdef ROUNDED
     // --- Logika za zaobljavanje coskova ---
     float r = 0.4; // Radijus zaobljenja (u UV koordinatama 0.0 do 1.0)
     bool discardPixel = false;
@@ -49,50 +72,48 @@ void main()
 
     if (discardPixel) discard; // Izbaci piksel (providno)
     // --------------------------------------
+#endif
 
-    // Get base color from texture or uniform
-    vec4 baseColor;
-    if(uUseTexture == 1)
-    {
-        vec4 texColor = texture(uTexture, TexCoord);
-        baseColor = texColor * uColor; 
-    }
-    else
-    {
-        baseColor = uColor;
-    }
+    Material material = uMaterials[uMaterialIndex];
+
+    // Get base color from texture or uniform, tinted by the material
+#ifdef TEXTURED
+    vec4 baseColor = texture(uTexture, TexCoord) * uColor;
+#else
+    vec4 baseColor = uColor;
+#endif
+    baseColor *= material.diffuse * VertexColor;
     
     // === PHONG LIGHTING CALCULATION ===
+#ifdef LIT
     vec3 finalLighting;
-    
-    if (uLightEnabled) {
+    {
         // Normalize the normal vector
         vec3 norm = normalize(Normal);
         
         // --- Ambient component ---
         float ambientStrength = 0.3;
-        vec3 ambient = ambientStrength * uLightColor;
+        vec3 ambient = ambientStrength * uLightColor.rgb;
         
         // --- Diffuse component ---
-        vec3 lightDir = normalize(uLightPos - FragPos);
+        vec3 lightDir = normalize(uLightPos.xyz - FragPos);
         float diff = max(dot(norm, lightDir), 0.0);
-        vec3 diffuse = diff * uLightColor;
+        vec3 diffuse = diff * uLightColor.rgb;
         
         // --- Specular component ---
-        float specularStrength = 0.5;
-        vec3 viewDir = normalize(uViewPos - FragPos);
+        vec3 viewDir = normalize(uViewPos.xyz - FragPos);
         vec3 reflectDir = reflect(-lightDir, norm);
-        float spec = pow(max(dot(viewDir, reflectDir), 0.0), 32.0);
-        vec3 specular = specularStrength * spec * uLightColor;
+        float spec = pow(max(dot(viewDir, reflectDir), 0.0), material.specular.w);
+        vec3 specular = material.specular.rgb * spec * uLightColor.rgb;
         
         // Combine all components
         finalLighting = (ambient + diffuse + specular) * uLightStrength;
     }
-    else {
-        // Light disabled - use only ambient lighting (dark scene)
-        float ambientStrength = 0.5;
-        finalLighting = vec3(ambientStrength);
-    }
+#else
+    // Light disabled - use only ambient lighting (dark scene)
+    float ambientStrength = 0.5;
+    vec3 finalLighting = vec3(ambientStrength);
+#endif
     
     // Apply lighting to base color
     FragColor = vec4(baseColor.rgb * finalLighting, baseColor.a);
@@ -5,14 +5,22 @@
 layout (location = 0) in vec3 aPos; // Changed to vec3 for 3D
 layout (location = 1) in vec2 aTexCoord;
 layout (location = 2) in vec3 aNormal; // Normal vector for 3D models
+layout (location = 3) in vec4 aColor;  // Per-vertex tint (UIBatch); white for everything else
 
 out vec2 TexCoord;
 out vec3 Normal;
 out vec3 FragPos;
+out vec4 VertexColor;
 
 uniform mat4 uModel;
-uniform mat4 uView;
-uniform mat4 uProjection;
+
+// Camera of the current pass, written once per frame (FrameUniforms, std140)
+layout(std140) uniform FrameData {
+    mat4 uView;
+    mat4 uProjection;
+    mat4 uViewProjection;
+    vec4 uViewPos;
+};
 
 // Legacy 2D uniforms - kept for backward compatibility during transition
 uniform vec2 uPos; 
@@ -23,8 +31,13 @@ void main()
     // 3D transformation pipeline
     vec4 worldPos = uModel * vec4(aPos, 1.0);
     FragPos = vec3(worldPos);
-    gl_Position = uProjection * uView * worldPos;
+    gl_Position = uViewProjection * worldPos;
     
     TexCoord = aTexCoord;
+    VertexColor = aColor;
+#ifdef LIT
     Normal = mat3(transpose(inverse(uModel))) * aNormal; // Transform normal to world space
+#else
+    Normal = aNormal; // Only lit variants read it
+#endif
 }
\ No newline at end of file
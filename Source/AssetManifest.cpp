@@ -0,0 +1,82 @@
+#include "../Header/AssetManifest.h"
+#include <iostream>
+#include <thread>
+
+AssetManifest::AssetManifest(ModelCache& cache)
+    : cache(cache), requestedStage(-1), readyStage(-1), startTime(std::chrono::steady_clock::now()) {}
+
+ModelHandle AssetManifest::addModel(int stage, const char* filepath) {
+    ModelHandle handle = cache.reserveModel(filepath);
+    models.push_back(ModelEntry{ stage, handle });
+    if (stage <= requestedStage) cache.requestModel(handle);
+    return handle;
+}
+
+void AssetManifest::addTexture(int stage, const char* filepath, TextureCallback onLoaded) {
+    textures.push_back(TextureEntry{ stage, filepath, onLoaded, INVALID_TEXTURE, false });
+    if (stage <= requestedStage) textures.back().handle = cache.getTextures().request(filepath);
+}
+
+void AssetManifest::requestStage(int stage) {
+    // Earlier stages go first in the worker queue
+    for (int s = requestedStage + 1; s <= stage; s++) {
+        for (const ModelEntry& entry : models) {
+            if (entry.stage == s) cache.requestModel(entry.handle);
+        }
+        for (TextureEntry& entry : textures) {
+            if (entry.stage == s) entry.handle = cache.getTextures().request(entry.path.c_str());
+        }
+    }
+    if (stage > requestedStage) requestedStage = stage;
+}
+
+// Run the callbacks of requested textures that finished loading
+bool AssetManifest::deliverTextures() {
+    TextureCache& textureCache = cache.getTextures();
+    bool delivered = false;
+    for (TextureEntry& entry : textures) {
+        if (entry.loaded || entry.handle == INVALID_TEXTURE) continue;
+        TextureStatus status = textureCache.getTexture(entry.handle)->status;
+        if (status == TEXTURE_LOADING) continue;
+
+        entry.loaded = true;
+        if (entry.onLoaded) entry.onLoaded(textureCache.getId(entry.handle));
+        delivered = true;
+    }
+    return delivered;
+}
+
+void AssetManifest::loadStage(int stage) {
+    requestStage(stage);
+    while (!isStageReady(stage)) {
+        bool progress = cache.pumpUploads(ASSET_UPLOAD_BUDGET_MS) > 0;
+        progress |= cache.getTextures().pumpUploads(ASSET_UPLOAD_BUDGET_MS) > 0;
+        progress |= deliverTextures();
+        if (!progress) std::this_thread::yield();
+    }
+}
+
+void AssetManifest::update(int currentStage, double budgetMs) {
+    requestStage(currentStage + 1);
+    cache.pumpUploads(budgetMs);
+    cache.getTextures().pumpUploads(budgetMs);
+    deliverTextures();
+
+    while (readyStage < requestedStage && isStageReady(readyStage + 1)) {
+        readyStage++;
+        double elapsedMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startTime).count();
+        std::cout << "Assets of stage " << readyStage << " ready after " << elapsedMs << " ms" << std::endl;
+    }
+}
+
+bool AssetManifest::isStageReady(int stage) const {
+    for (const ModelEntry& entry : models) {
+        if (entry.stage > stage) continue;
+        const Model* model = cache.getModel(entry.handle);
+        if (model && (model->status == MODEL_UNLOADED || model->status == MODEL_LOADING)) return false;
+    }
+    for (const TextureEntry& entry : textures) {
+        if (entry.stage <= stage && !entry.loaded) return false;
+    }
+    return true;
+}
@@ -0,0 +1,118 @@
+#include "../Header/Bounds.h"
+#include <algorithm>
+#include <cmath>
+
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#define BOUNDS_SSE 1
+#include <xmmintrin.h>
+#endif
+
+// Positions are fetched through a functor so the plain and indexed variants
+// share one reduction
+template <typename Fetch>
+static Bounds reduceBounds(size_t count, Fetch position) {
+    Bounds bounds = {};
+    if (count == 0) return bounds;
+
+#ifdef BOUNDS_SSE
+    // Min/max of x, y, z (and the ignored fourth float) in one register each
+    __m128 lo = _mm_loadu_ps(position(0));
+    __m128 hi = lo;
+    for (size_t i = 1; i < count; i++) {
+        __m128 p = _mm_loadu_ps(position(i));
+        lo = _mm_min_ps(lo, p);
+        hi = _mm_max_ps(hi, p);
+    }
+    float lo4[4], hi4[4];
+    _mm_storeu_ps(lo4, lo);
+    _mm_storeu_ps(hi4, hi);
+    for (int axis = 0; axis < 3; axis++) {
+        bounds.min[axis] = lo4[axis];
+        bounds.max[axis] = hi4[axis];
+    }
+#else
+    const float* first = position(0);
+    for (int axis = 0; axis < 3; axis++) bounds.min[axis] = bounds.max[axis] = first[axis];
+    for (size_t i = 1; i < count; i++) {
+        const float* p = position(i);
+        for (int axis = 0; axis < 3; axis++) {
+            bounds.min[axis] = std::min(bounds.min[axis], p[axis]);
+            bounds.max[axis] = std::max(bounds.max[axis], p[axis]);
+        }
+    }
+#endif
+
+    for (int axis = 0; axis < 3; axis++) bounds.center[axis] = (bounds.min[axis] + bounds.max[axis]) * 0.5f;
+
+    // Sphere radius: farthest position from the box center (tighter than half the diagonal)
+    float maxDistance2 = 0.0f;
+    size_t i = 0;
+#ifdef BOUNDS_SSE
+    // Four positions at a time, transposed to x/y/z rows
+    __m128 cx = _mm_set1_ps(bounds.center[0]);
+    __m128 cy = _mm_set1_ps(bounds.center[1]);
+    __m128 cz = _mm_set1_ps(bounds.center[2]);
+    __m128 farthest = _mm_setzero_ps();
+    for (; i + 4 <= count; i += 4) {
+        __m128 x = _mm_loadu_ps(position(i + 0));
+        __m128 y = _mm_loadu_ps(position(i + 1));
+        __m128 z = _mm_loadu_ps(position(i + 2));
+        __m128 w = _mm_loadu_ps(position(i + 3));
+        _MM_TRANSPOSE4_PS(x, y, z, w);
+        __m128 dx = _mm_sub_ps(x, cx);
+        __m128 dy = _mm_sub_ps(y, cy);
+        __m128 dz = _mm_sub_ps(z, cz);
+        __m128 d2 = _mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy)), _mm_mul_ps(dz, dz));
+        farthest = _mm_max_ps(farthest, d2);
+    }
+    float farthest4[4];
+    _mm_storeu_ps(farthest4, farthest);
+    maxDistance2 = std::max(std::max(farthest4[0], farthest4[1]), std::max(farthest4[2], farthest4[3]));
+#endif
+    for (; i < count; i++) {
+        const float* p = position(i);
+        float dx = p[0] - bounds.center[0];
+        float dy = p[1] - bounds.center[1];
+        float dz = p[2] - bounds.center[2];
+        maxDistance2 = std::max(maxDistance2, dx * dx + dy * dy + dz * dz);
+    }
+    bounds.radius = std::sqrt(maxDistance2);
+    return bounds;
+}
+
+Bounds computeBounds(const float* positions, size_t count, size_t stride) {
+    const char* base = reinterpret_cast<const char*>(positions);
+    return reduceBounds(count, [base, stride](size_t i) {
+        return reinterpret_cast<const float*>(base + i * stride);
+    });
+}
+
+Bounds computeBounds(const float* positions, size_t stride, const uint32_t* indices, size_t indexCount) {
+    const char* base = reinterpret_cast<const char*>(positions);
+    return reduceBounds(indexCount, [base, stride, indices](size_t i) {
+        return reinterpret_cast<const float*>(base + indices[i] * stride);
+    });
+}
+
+Bounds transformBounds(const Bounds& bounds, const glm::mat4& transform) {
+    // Each output axis gathers the smaller and larger product per input axis (Arvo)
+    Bounds result = {};
+    for (int axis = 0; axis < 3; axis++) {
+        result.min[axis] = result.max[axis] = transform[3][axis];
+        for (int j = 0; j < 3; j++) {
+            float a = transform[j][axis] * bounds.min[j];
+            float b = transform[j][axis] * bounds.max[j];
+            result.min[axis] += std::min(a, b);
+            result.max[axis] += std::max(a, b);
+        }
+    }
+
+    glm::vec3 center = glm::vec3(transform * glm::vec4(bounds.center[0], bounds.center[1], bounds.center[2], 1.0f));
+    float scale = std::max(glm::length(glm::vec3(transform[0])),
+                  std::max(glm::length(glm::vec3(transform[1])), glm::length(glm::vec3(transform[2]))));
+    result.center[0] = center.x;
+    result.center[1] = center.y;
+    result.center[2] = center.z;
+    result.radius = bounds.radius * scale;
+    return result;
+}
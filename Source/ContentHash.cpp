@@ -0,0 +1,22 @@
+#include "../Header/ContentHash.h"
+#include <cstring>
+
+uint64_t hashBytes(const void* data, size_t size) {
+    // FNV-1a style mixing over 8-byte words; fast enough to hash the largest
+    // OBJ in well under a millisecond while still catching any edit
+    const unsigned char* bytes = static_cast<const unsigned char*>(data);
+    const uint64_t prime = 0x100000001B3ull;
+    uint64_t h = 0xCBF29CE484222325ull ^ size;
+
+    size_t i = 0;
+    for (; i + 8 <= size; i += 8) {
+        uint64_t word;
+        std::memcpy(&word, bytes + i, 8);
+        h = (h ^ word) * prime;
+        h ^= h >> 32;
+    }
+    for (; i < size; i++) {
+        h = (h ^ bytes[i]) * prime;
+    }
+    return h ^ (h >> 29);
+}
@@ -0,0 +1,122 @@
+#include "../Header/CookedMesh.h"
+#include <fstream>
+#include <vector>
+#include <cstring>
+
+std::string cookedMeshPath(const char* objPath) {
+    std::string path(objPath);
+    size_t dot = path.find_last_of('.');
+    size_t slash = path.find_last_of("/\\");
+    if (dot != std::string::npos && (slash == std::string::npos || dot > slash)) {
+        path.erase(dot);
+    }
+    return path + ".mesh";
+}
+
+static uint64_t alignTo(uint64_t offset, uint64_t alignment) {
+    return (offset + alignment - 1) / alignment * alignment;
+}
+
+bool writeCookedMesh(const char* path, uint64_t sourceHash, uint64_t sourceSize, const MeshData& mesh) {
+    CookedMeshHeader header;
+    std::memset(&header, 0, sizeof(header));
+    header.magic = COOKED_MESH_MAGIC;
+    header.version = COOKED_MESH_VERSION;
+    header.sourceHash = sourceHash;
+    header.sourceSize = sourceSize;
+    bool packed = !mesh.packedVertices.empty();
+    header.vertexCount = (uint32_t)mesh.vertices.size();
+    header.vertexStride = packed ? sizeof(PackedVertex) : sizeof(Vertex);
+    header.vertexFormat = packed ? VERTEX_FORMAT_PACKED : VERTEX_FORMAT_FLOAT;
+    header.indexCount = (uint32_t)mesh.indices.size();
+    header.indexSize = mesh.vertices.size() <= 0xFFFF ? 2 : 4;
+    header.submeshCount = (uint32_t)mesh.submeshes.size();
+    header.lodCount = (uint32_t)mesh.lods.size();
+    header.bounds = mesh.bounds;
+    std::strncpy(header.materialLibrary, mesh.materialLibrary.c_str(), sizeof(header.materialLibrary) - 1);
+    header.positionScale = mesh.positionScale;
+    std::memcpy(header.positionOffset, mesh.positionOffset, sizeof(header.positionOffset));
+
+    header.vertexOffset = alignTo(sizeof(CookedMeshHeader), 16);
+    header.indexOffset = alignTo(header.vertexOffset + (uint64_t)header.vertexCount * header.vertexStride, 16);
+    header.submeshOffset = alignTo(header.indexOffset + (uint64_t)header.indexCount * header.indexSize, 16);
+    header.lodOffset = alignTo(header.submeshOffset + (uint64_t)header.submeshCount * sizeof(Submesh), 16);
+
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file.is_open()) return false;
+
+    auto writeAt = [&file](uint64_t offset, const void* data, size_t size) {
+        static const char padding[16] = {};
+        uint64_t position = (uint64_t)file.tellp();
+        if (offset > position) file.write(padding, (std::streamsize)(offset - position));
+        file.write(static_cast<const char*>(data), (std::streamsize)size);
+    };
+
+    writeAt(0, &header, sizeof(header));
+    if (packed) {
+        writeAt(header.vertexOffset, mesh.packedVertices.data(), mesh.packedVertices.size() * sizeof(PackedVertex));
+    }
+    else {
+        writeAt(header.vertexOffset, mesh.vertices.data(), mesh.vertices.size() * sizeof(Vertex));
+    }
+    if (header.indexSize == 2) {
+        std::vector<uint16_t> shortIndices(mesh.indices.begin(), mesh.indices.end());
+        writeAt(header.indexOffset, shortIndices.data(), shortIndices.size() * sizeof(uint16_t));
+    }
+    else {
+        writeAt(header.indexOffset, mesh.indices.data(), mesh.indices.size() * sizeof(uint32_t));
+    }
+    writeAt(header.submeshOffset, mesh.submeshes.data(), mesh.submeshes.size() * sizeof(Submesh));
+    writeAt(header.lodOffset, mesh.lods.data(), mesh.lods.size() * sizeof(MeshLod));
+
+    return file.good();
+}
+
+bool CookedMesh::open(const char* path, uint64_t sourceHash, uint64_t sourceSize, bool allowPacked) {
+    header = nullptr;
+    if (!file.open(path)) return false;
+
+    // Unmap a rejected file right away; the caller is about to rewrite it
+    if (!validate(sourceHash, sourceSize, allowPacked)) {
+        file.close();
+        return false;
+    }
+    header = reinterpret_cast<const CookedMeshHeader*>(file.data());
+    return true;
+}
+
+bool CookedMesh::validate(uint64_t sourceHash, uint64_t sourceSize, bool allowPacked) const {
+    if (file.size() < sizeof(CookedMeshHeader)) return false;
+
+    const CookedMeshHeader* h = reinterpret_cast<const CookedMeshHeader*>(file.data());
+    if (h->magic != COOKED_MESH_MAGIC || h->version != COOKED_MESH_VERSION) return false;
+    if (h->sourceHash != sourceHash || h->sourceSize != sourceSize) return false;
+    if (h->indexSize != 2 && h->indexSize != 4) return false;
+    if (h->vertexFormat == VERTEX_FORMAT_FLOAT) {
+        if (h->vertexStride != sizeof(Vertex)) return false;
+    }
+    else if (h->vertexFormat == VERTEX_FORMAT_PACKED) {
+        if (h->vertexStride != sizeof(PackedVertex) || !allowPacked) return false;
+    }
+    else {
+        return false;
+    }
+
+    // Every section must lie inside the mapped file
+    uint64_t size = file.size();
+    if (h->vertexOffset + (uint64_t)h->vertexCount * h->vertexStride > size) return false;
+    if (h->indexOffset + (uint64_t)h->indexCount * h->indexSize > size) return false;
+    if (h->submeshOffset + (uint64_t)h->submeshCount * sizeof(Submesh) > size) return false;
+    if (h->lodOffset + (uint64_t)h->lodCount * sizeof(MeshLod) > size) return false;
+    // Draws read a submesh's range straight from the shared element buffer
+    const Submesh* submeshes = reinterpret_cast<const Submesh*>(file.data() + h->submeshOffset);
+    for (uint32_t i = 0; i < h->submeshCount; i++) {
+        if ((uint64_t)submeshes[i].firstIndex + submeshes[i].indexCount > h->indexCount) return false;
+    }
+    const MeshLod* lods = reinterpret_cast<const MeshLod*>(file.data() + h->lodOffset);
+    for (uint32_t i = 0; i < h->lodCount; i++) {
+        if ((uint64_t)lods[i].firstSubmesh + lods[i].submeshCount > h->submeshCount) return false;
+    }
+    if (std::memchr(h->materialLibrary, 0, sizeof(h->materialLibrary)) == nullptr) return false;
+    return true;
+}
@@ -0,0 +1,139 @@
+#include "../Header/CookedTexture.h"
+#include <fstream>
+#include <cstring>
+
+std::string cookedTexturePath(const char* imagePath) {
+    return std::string(imagePath) + ".tex";
+}
+
+static uint64_t alignTo(uint64_t offset, uint64_t alignment) {
+    return (offset + alignment - 1) / alignment * alignment;
+}
+
+void buildMipChain(const unsigned char* image, uint32_t width, uint32_t height, uint32_t channels, TextureData& texture) {
+    static const uint32_t internalFormats[4] = { GL_R8, GL_RG8, GL_RGB8, GL_RGBA8 };
+    static const uint32_t formats[4] = { GL_RED, GL_RG, GL_RGB, GL_RGBA };
+    texture.width = width;
+    texture.height = height;
+    texture.channels = channels;
+    texture.internalFormat = internalFormats[channels - 1];
+    texture.format = formats[channels - 1];
+
+    // Level sizes first, so the pixels are allocated once
+    texture.levels.clear();
+    uint64_t total = 0;
+    uint32_t w = width, h = height;
+    while (true) {
+        uint64_t size = (uint64_t)w * h * channels;
+        texture.levels.push_back(CookedTextureLevel{ w, h, total, size });
+        total += size;
+        if ((w == 1 && h == 1) || texture.levels.size() == MAX_TEXTURE_LEVELS) break;
+        w = w > 1 ? w / 2 : 1;
+        h = h > 1 ? h / 2 : 1;
+    }
+    texture.pixels.resize(total);
+    std::memcpy(texture.pixels.data(), image, texture.levels[0].size);
+
+    for (size_t level = 1; level < texture.levels.size(); level++) {
+        const CookedTextureLevel& src = texture.levels[level - 1];
+        const CookedTextureLevel& dst = texture.levels[level];
+        const unsigned char* in = texture.pixels.data() + src.offset;
+        unsigned char* out = texture.pixels.data() + dst.offset;
+
+        // A side that is already 1 texel is not halved; clamping the second
+        // sample makes that case average a texel with itself
+        for (uint32_t y = 0; y < dst.height; y++) {
+            uint32_t y0 = y * 2;
+            uint32_t y1 = y0 + 1 < src.height ? y0 + 1 : y0;
+            for (uint32_t x = 0; x < dst.width; x++) {
+                uint32_t x0 = x * 2;
+                uint32_t x1 = x0 + 1 < src.width ? x0 + 1 : x0;
+                for (uint32_t c = 0; c < channels; c++) {
+                    uint32_t sum = in[((size_t)y0 * src.width + x0) * channels + c] + in[((size_t)y0 * src.width + x1) * channels + c] +
+                                   in[((size_t)y1 * src.width + x0) * channels + c] + in[((size_t)y1 * src.width + x1) * channels + c];
+                    out[((size_t)y * dst.width + x) * channels + c] = (unsigned char)((sum + 2) / 4);
+                }
+            }
+        }
+    }
+}
+
+bool writeCookedTexture(const char* path, uint64_t sourceHash, uint64_t sourceSize, const TextureData& texture,
+                        const TextureCookOptions& options, uint32_t supportedCompression) {
+    CookedTextureHeader header;
+    std::memset(&header, 0, sizeof(header));
+    header.magic = COOKED_TEXTURE_MAGIC;
+    header.version = COOKED_TEXTURE_VERSION;
+    header.sourceHash = sourceHash;
+    header.sourceSize = sourceSize;
+    header.width = texture.width;
+    header.height = texture.height;
+    header.channels = texture.channels;
+    header.levelCount = (uint32_t)texture.levels.size();
+    header.internalFormat = texture.internalFormat;
+    header.format = texture.format;
+    header.type = GL_UNSIGNED_BYTE;
+    header.compression = texture.compression;
+    header.requestedCompression = options.compression;
+    header.quality = options.quality;
+    header.supportedCompression = supportedCompression;
+    header.levelOffset = alignTo(sizeof(CookedTextureHeader), 16);
+    header.dataOffset = alignTo(header.levelOffset + header.levelCount * sizeof(CookedTextureLevel), 16);
+    header.dataSize = texture.pixels.size();
+
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file.is_open()) return false;
+
+    auto writeAt = [&file](uint64_t offset, const void* data, size_t size) {
+        static const char padding[16] = {};
+        uint64_t position = (uint64_t)file.tellp();
+        if (offset > position) file.write(padding, (std::streamsize)(offset - position));
+        file.write(static_cast<const char*>(data), (std::streamsize)size);
+    };
+
+    writeAt(0, &header, sizeof(header));
+    writeAt(header.levelOffset, texture.levels.data(), texture.levels.size() * sizeof(CookedTextureLevel));
+    writeAt(header.dataOffset, texture.pixels.data(), texture.pixels.size());
+
+    return file.good();
+}
+
+bool CookedTexture::open(const char* path, uint64_t sourceHash, uint64_t sourceSize, const TextureCookOptions& options, uint32_t supportedCompression) {
+    header = nullptr;
+    if (!file.open(path)) return false;
+
+    // Unmap a rejected file right away; the caller is about to rewrite it
+    if (!validate(sourceHash, sourceSize, options, supportedCompression)) {
+        file.close();
+        return false;
+    }
+    header = reinterpret_cast<const CookedTextureHeader*>(file.data());
+    return true;
+}
+
+bool CookedTexture::validate(uint64_t sourceHash, uint64_t sourceSize, const TextureCookOptions& options, uint32_t supportedCompression) const {
+    if (file.size() < sizeof(CookedTextureHeader)) return false;
+
+    const CookedTextureHeader* h = reinterpret_cast<const CookedTextureHeader*>(file.data());
+    if (h->magic != COOKED_TEXTURE_MAGIC || h->version != COOKED_TEXTURE_VERSION) return false;
+    if (h->sourceHash != sourceHash || h->sourceSize != sourceSize) return false;
+    if (h->levelCount == 0 || h->levelCount > MAX_TEXTURE_LEVELS) return false;
+    if (h->channels < 1 || h->channels > 4) return false;
+    if (h->requestedCompression != options.compression || h->quality != options.quality) return false;
+    if (h->compression >= TEXTURE_COMPRESSION_AUTO) return false;
+
+    // Driver support only matters for the formats this request could have picked,
+    // so uncompressed cooks survive on any driver
+    uint32_t candidates = compressionCandidates(options.compression);
+    if ((h->supportedCompression & candidates) != (supportedCompression & candidates)) return false;
+
+    // Every level must lie inside the mapped file
+    uint64_t size = file.size();
+    if (h->levelOffset + (uint64_t)h->levelCount * sizeof(CookedTextureLevel) > size) return false;
+    if (h->dataOffset + h->dataSize > size) return false;
+    const CookedTextureLevel* levels = reinterpret_cast<const CookedTextureLevel*>(file.data() + h->levelOffset);
+    for (uint32_t i = 0; i < h->levelCount; i++) {
+        if (levels[i].offset + levels[i].size > h->dataSize) return false;
+    }
+    return true;
+}
@@ -0,0 +1,73 @@
+#include "../Header/FrameUniforms.h"
+#include <glm/gtc/type_ptr.hpp>
+#include <cstring>
+
+static size_t alignTo(size_t offset, size_t alignment) {
+    return (offset + alignment - 1) / alignment * alignment;
+}
+
+FrameUniforms::FrameUniforms() : frames(), lights(), ubo(0), lightOffset(0), passStride(0) {}
+
+FrameUniforms::~FrameUniforms() {
+    destroy();
+}
+
+void FrameUniforms::setCamera(FramePass pass, const glm::mat4& view, const glm::mat4& projection, const glm::vec3& viewPos) {
+    GpuFrameData& frame = frames[pass];
+    glm::mat4 viewProjection = projection * view;
+    std::memcpy(frame.view, glm::value_ptr(view), sizeof(frame.view));
+    std::memcpy(frame.projection, glm::value_ptr(projection), sizeof(frame.projection));
+    std::memcpy(frame.viewProjection, glm::value_ptr(viewProjection), sizeof(frame.viewProjection));
+    frame.viewPos[0] = viewPos.x;
+    frame.viewPos[1] = viewPos.y;
+    frame.viewPos[2] = viewPos.z;
+    frame.viewPos[3] = 1.0f;
+}
+
+void FrameUniforms::setLight(FramePass pass, const Light& light) {
+    GpuLightData& data = lights[pass];
+    data.position[0] = light.position.x;
+    data.position[1] = light.position.y;
+    data.position[2] = light.position.z;
+    data.position[3] = 1.0f;
+    data.color[0] = light.color.r;
+    data.color[1] = light.color.g;
+    data.color[2] = light.color.b;
+    data.color[3] = 1.0f;
+    data.strength = light.strength;
+    data.enabled = light.enabled ? 1 : 0;
+}
+
+void FrameUniforms::upload() {
+    if (ubo == 0) {
+        GLint alignment = 256;
+        glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &alignment);
+        if (alignment < 1) alignment = 256;
+        lightOffset = alignTo(sizeof(GpuFrameData), (size_t)alignment);
+        passStride = alignTo(lightOffset + sizeof(GpuLightData), (size_t)alignment);
+        glGenBuffers(1, &ubo);
+    }
+
+    staging.resize(passStride * FRAME_PASS_COUNT);
+    for (int pass = 0; pass < FRAME_PASS_COUNT; pass++) {
+        std::memcpy(staging.data() + pass * passStride, &frames[pass], sizeof(GpuFrameData));
+        std::memcpy(staging.data() + pass * passStride + lightOffset, &lights[pass], sizeof(GpuLightData));
+    }
+
+    // Orphan the previous frame's storage instead of waiting for draws still reading it
+    glBindBuffer(GL_UNIFORM_BUFFER, ubo);
+    glBufferData(GL_UNIFORM_BUFFER, staging.size(), nullptr, GL_STREAM_DRAW);
+    glBufferSubData(GL_UNIFORM_BUFFER, 0, staging.size(), staging.data());
+    glBindBuffer(GL_UNIFORM_BUFFER, 0);
+}
+
+void FrameUniforms::bind(FramePass pass) const {
+    if (ubo == 0) return;
+    glBindBufferRange(GL_UNIFORM_BUFFER, FRAME_BLOCK_BINDING, ubo, pass * passStride, sizeof(GpuFrameData));
+    glBindBufferRange(GL_UNIFORM_BUFFER, LIGHT_BLOCK_BINDING, ubo, pass * passStride + lightOffset, sizeof(GpuLightData));
+}
+
+void FrameUniforms::destroy() {
+    if (ubo != 0) glDeleteBuffers(1, &ubo);
+    ubo = 0;
+}
@@ -0,0 +1,175 @@
+#include "../Header/GeometryArena.h"
+#include "../Header/Model.h"
+#include <algorithm>
+
+GeometryArena::GeometryArena(bool packed)
+    : packed(packed), VAO(0), VBO(0), EBO(0), vertexCapacity(0), indexCapacity(0), vertexUsed(0), indexUsed(0) {}
+
+GeometryArena::~GeometryArena() {
+    destroy();
+}
+
+uint32_t GeometryArena::stride() const {
+    return packed ? sizeof(PackedVertex) : sizeof(Vertex);
+}
+
+// Buffers are created on the first allocation, when a GL context surely exists.
+// All data transfers go through the copy targets so the VAO's element buffer
+// binding is never disturbed.
+void GeometryArena::create() {
+    vertexCapacity = ARENA_INITIAL_VERTEX_BYTES - ARENA_INITIAL_VERTEX_BYTES % stride();
+    indexCapacity = ARENA_INITIAL_INDEX_BYTES;
+
+    glGenVertexArrays(1, &VAO);
+    glGenBuffers(1, &VBO);
+    glGenBuffers(1, &EBO);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, VBO);
+    glBufferData(GL_COPY_WRITE_BUFFER, (GLsizeiptr)vertexCapacity, nullptr, GL_STATIC_DRAW);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, EBO);
+    glBufferData(GL_COPY_WRITE_BUFFER, (GLsizeiptr)indexCapacity, nullptr, GL_STATIC_DRAW);
+
+    freeVertices.assign(1, Range{ 0, vertexCapacity });
+    freeIndices.assign(1, Range{ 0, indexCapacity });
+    setupVertexArray();
+}
+
+// Record the attribute layout and element buffer in the VAO (again after a buffer grew)
+void GeometryArena::setupVertexArray() {
+    glBindVertexArray(VAO);
+    glBindBuffer(GL_ARRAY_BUFFER, VBO);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
+
+    GLsizei vertexStride = (GLsizei)stride();
+    if (packed) {
+        // Position attribute (location 0), snorm16 in [-1, 1]
+        glVertexAttribPointer(0, 3, GL_SHORT, GL_TRUE, vertexStride, (void*)offsetof(PackedVertex, x));
+
+        // Texture coordinate attribute (location 1), half float
+        glVertexAttribPointer(1, 2, GL_HALF_FLOAT, GL_FALSE, vertexStride, (void*)offsetof(PackedVertex, u));
+
+        // Normal attribute (location 2), 10:10:10:2 signed normalized
+        glVertexAttribPointer(2, 4, GL_INT_2_10_10_10_REV, GL_TRUE, vertexStride, (void*)offsetof(PackedVertex, normal));
+    }
+    else {
+        // Position attribute (location 0)
+        glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, vertexStride, (void*)0);
+
+        // Texture coordinate attribute (location 1)
+        glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, vertexStride, (void*)(3 * sizeof(float)));
+
+        // Normal attribute (location 2)
+        glVertexAttribPointer(2, 3, GL_FLOAT, GL_FALSE, vertexStride, (void*)(5 * sizeof(float)));
+    }
+    glEnableVertexAttribArray(0);
+    glEnableVertexAttribArray(1);
+    glEnableVertexAttribArray(2);
+
+    glBindVertexArray(0);
+}
+
+// Replace a buffer with one at least twice as large, keeping its contents and offsets
+void GeometryArena::grow(GLenum target, unsigned int& buffer, uint64_t& capacity, std::vector<Range>& freeRanges, uint64_t needed) {
+    uint64_t newCapacity = std::max(capacity * 2, capacity + needed);
+    if (target == GL_ARRAY_BUFFER) newCapacity -= newCapacity % stride();
+
+    unsigned int newBuffer = 0;
+    glGenBuffers(1, &newBuffer);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, newBuffer);
+    glBufferData(GL_COPY_WRITE_BUFFER, (GLsizeiptr)newCapacity, nullptr, GL_STATIC_DRAW);
+    glBindBuffer(GL_COPY_READ_BUFFER, buffer);
+    glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0, 0, (GLsizeiptr)capacity);
+    glDeleteBuffers(1, &buffer);
+
+    buffer = newBuffer;
+    releaseRange(freeRanges, capacity, newCapacity - capacity);
+    capacity = newCapacity;
+    setupVertexArray();
+}
+
+bool GeometryArena::allocateRange(std::vector<Range>& freeRanges, uint64_t size, uint64_t alignment, uint64_t& offset) {
+    for (size_t i = 0; i < freeRanges.size(); i++) {
+        Range& range = freeRanges[i];
+        uint64_t start = (range.offset + alignment - 1) / alignment * alignment;
+        if (start + size > range.offset + range.size) continue;
+
+        // Keep the alignment gap in front and the tail behind as free ranges
+        uint64_t end = range.offset + range.size;
+        uint64_t gap = start - range.offset;
+        offset = start;
+        if (gap > 0) {
+            range.size = gap;
+            if (start + size < end) freeRanges.insert(freeRanges.begin() + i + 1, Range{ start + size, end - start - size });
+        }
+        else if (start + size < end) {
+            range.offset = start + size;
+            range.size = end - range.offset;
+        }
+        else {
+            freeRanges.erase(freeRanges.begin() + i);
+        }
+        return true;
+    }
+    return false;
+}
+
+void GeometryArena::releaseRange(std::vector<Range>& freeRanges, uint64_t offset, uint64_t size) {
+    if (size == 0) return;
+    auto next = std::lower_bound(freeRanges.begin(), freeRanges.end(), offset,
+                                 [](const Range& range, uint64_t value) { return range.offset < value; });
+    next = freeRanges.insert(next, Range{ offset, size });
+
+    // Merge with the following and the preceding range
+    if (next + 1 != freeRanges.end() && next->offset + next->size == (next + 1)->offset) {
+        next->size += (next + 1)->size;
+        freeRanges.erase(next + 1);
+    }
+    if (next != freeRanges.begin() && (next - 1)->offset + (next - 1)->size == next->offset) {
+        (next - 1)->size += next->size;
+        freeRanges.erase(next);
+    }
+}
+
+GeometryAllocation GeometryArena::allocate(const void* vertexData, uint32_t vertexCount, const void* indexData, uint64_t indexBytes) {
+    if (VAO == 0) create();
+
+    GeometryAllocation allocation = {};
+    allocation.vertexBytes = (uint64_t)vertexCount * stride();
+    allocation.indexBytes = indexBytes;
+
+    while (!allocateRange(freeVertices, allocation.vertexBytes, stride(), allocation.vertexOffset)) {
+        grow(GL_ARRAY_BUFFER, VBO, vertexCapacity, freeVertices, allocation.vertexBytes);
+    }
+    // 32-bit indices need 4-byte aligned offsets; 16-bit ones are fine with that too
+    while (!allocateRange(freeIndices, allocation.indexBytes, 4, allocation.indexOffset)) {
+        grow(GL_ELEMENT_ARRAY_BUFFER, EBO, indexCapacity, freeIndices, allocation.indexBytes);
+    }
+    allocation.baseVertex = (int32_t)(allocation.vertexOffset / stride());
+
+    glBindBuffer(GL_COPY_WRITE_BUFFER, VBO);
+    glBufferSubData(GL_COPY_WRITE_BUFFER, (GLintptr)allocation.vertexOffset, (GLsizeiptr)allocation.vertexBytes, vertexData);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, EBO);
+    glBufferSubData(GL_COPY_WRITE_BUFFER, (GLintptr)allocation.indexOffset, (GLsizeiptr)allocation.indexBytes, indexData);
+
+    vertexUsed += allocation.vertexBytes;
+    indexUsed += allocation.indexBytes;
+    return allocation;
+}
+
+void GeometryArena::release(const GeometryAllocation& allocation) {
+    if (VAO == 0) return;
+    releaseRange(freeVertices, allocation.vertexOffset, allocation.vertexBytes);
+    releaseRange(freeIndices, allocation.indexOffset, allocation.indexBytes);
+    vertexUsed -= allocation.vertexBytes;
+    indexUsed -= allocation.indexBytes;
+}
+
+void GeometryArena::destroy() {
+    if (VBO != 0) glDeleteBuffers(1, &VBO);
+    if (EBO != 0) glDeleteBuffers(1, &EBO);
+    if (VAO != 0) glDeleteVertexArrays(1, &VAO);
+    VAO = VBO = EBO = 0;
+    vertexCapacity = indexCapacity = 0;
+    vertexUsed = indexUsed = 0;
+    freeVertices.clear();
+    freeIndices.clear();
+}
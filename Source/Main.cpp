@@ -4,6 +4,7 @@
 #include <vector>
 #include <string>
 #include <cmath> 
+#include <filesystem>
 
 // GLM includes for 3D math
 #include <glm/glm.hpp>
@@ -12,6 +13,14 @@
 
 #include "../Header/Util.h"
 #include "../Header/Model.h"
+#include "../Header/ObjParser.h"
+#include "../Header/RenderQueue.h"
+#include "../Header/AssetManifest.h"
+#include "../Header/TextureCache.h"
+#include "../Header/CookedTexture.h"
+#include "../Header/TextureAtlas.h"
+#include "../Header/UIBatch.h"
+#include "../Header/FrameUniforms.h"
 #include "../Header/GameObject.h"
 #include "../Header/Camera.h"
 #include "../Header/Light.h"
@@ -54,6 +63,9 @@ struct Ingredient {
 const double TARGET_FPS = 75.0;
 const double OPTIMAL_TIME = 1.0 / TARGET_FPS;
 
+// Geometry of models not drawn recently is dropped above this (they reload from the cooked cache)
+const uint64_t MODEL_MEMORY_BUDGET = 256ull * 1024 * 1024;
+
 // --- POMOCNE FUNKCIJE ---
 
 bool CheckCollision(GameObject& one, GameObject& two) {
@@ -120,10 +132,12 @@ bool CheckCollision3D(GameObject& one, GameObject& two) {
 }
 
 // Updated RenderObject to use 3D transformations
-void RenderObject(unsigned int shader, unsigned int VAO, GameObject& obj, Camera& camera, float aspectRatio, int roundingMode = 0) {
+// The camera comes from the bound FrameData range (FRAME_PASS_SCENE)
+void RenderObject(ShaderVariants& shaders, uint32_t passFeatures, unsigned int VAO, GameObject& obj, int roundingMode = 0) {
     if (!obj.isVisible) return;
 
-    glUseProgram(shader);
+    ShaderProgram& shader = shaders.get(shaderFeatures(passFeatures, obj.useTexture ? obj.textureId : 0, roundingMode));
+    shader.use();
 
     // Create model matrix (position in 3D space, facing camera)
     glm::mat4 model = glm::mat4(1.0f);
@@ -135,84 +149,64 @@ void RenderObject(unsigned int shader, unsigned int VAO, GameObject& obj, Camera
     model = glm::rotate(model, glm::radians(obj.rotateY), glm::vec3(0.0f, 1.0f, 0.0f));
     model = glm::rotate(model, glm::radians(obj.rotateZ), glm::vec3(0.0f, 0.0f, 1.0f));
 
-    // Get view and projection matrices from camera
-    glm::mat4 view = camera.getViewMatrix();
-    glm::mat4 projection = camera.getProjectionMatrix(aspectRatio);
-
-    // Set matrix uniforms
-    unsigned int uModelLoc = glGetUniformLocation(shader, "uModel");
-    unsigned int uViewLoc = glGetUniformLocation(shader, "uView");
-    unsigned int uProjLoc = glGetUniformLocation(shader, "uProjection");
-
-    glUniformMatrix4fv(uModelLoc, 1, GL_FALSE, glm::value_ptr(model));
-    glUniformMatrix4fv(uViewLoc, 1, GL_FALSE, glm::value_ptr(view));
-    glUniformMatrix4fv(uProjLoc, 1, GL_FALSE, glm::value_ptr(projection));
+    shader.set(UNIFORM_MODEL, model);
 
-    unsigned int uColorLoc = glGetUniformLocation(shader, "uColor");
-    unsigned int uUseTexLoc = glGetUniformLocation(shader, "uUseTexture");
-    unsigned int uRoundingLoc = glGetUniformLocation(shader, "uRounding");
-
-    glUniform4f(uColorLoc, obj.r, obj.g, obj.b, obj.a);
-    glUniform1i(uRoundingLoc, roundingMode);
+    shader.set(UNIFORM_COLOR, glm::vec4(obj.r, obj.g, obj.b, obj.a));
+    shader.set(UNIFORM_ROUNDING, roundingMode);
 
     if (obj.useTexture) {
-        glUniform1i(uUseTexLoc, 1);
         glActiveTexture(GL_TEXTURE0);
         glBindTexture(GL_TEXTURE_2D, obj.textureId);
     }
-    else {
-        glUniform1i(uUseTexLoc, 0);
-    }
 
     glBindVertexArray(VAO);
     glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
     glBindVertexArray(0);
 }
 
-// Render 2D UI overlay elements (unaffected by camera)
-// Uses orthographic projection and identity view matrix
-void RenderUIObject(unsigned int shader, unsigned int VAO, GameObject& obj, Camera& camera, int roundingMode = 0) {
-    if (!obj.isVisible) return;
-
-    glUseProgram(shader);
-
-    // Create model matrix for 2D positioning
-    glm::mat4 model = glm::mat4(1.0f);
-    model = glm::translate(model, glm::vec3(obj.x, obj.y, 0.0f));  // Z is always 0 for UI
-    model = glm::scale(model, glm::vec3(obj.w, obj.h, 1.0f));
-
-    // Get UI projection and view matrices (orthographic + identity)
-    glm::mat4 view = camera.getUIViewMatrix();
-    glm::mat4 projection = camera.getOrthoProjectionMatrix();
-
-    // Set matrix uniforms
-    unsigned int uModelLoc = glGetUniformLocation(shader, "uModel");
-    unsigned int uViewLoc = glGetUniformLocation(shader, "uView");
-    unsigned int uProjLoc = glGetUniformLocation(shader, "uProjection");
-
-    glUniformMatrix4fv(uModelLoc, 1, GL_FALSE, glm::value_ptr(model));
-    glUniformMatrix4fv(uViewLoc, 1, GL_FALSE, glm::value_ptr(view));
-    glUniformMatrix4fv(uProjLoc, 1, GL_FALSE, glm::value_ptr(projection));
-
-    unsigned int uColorLoc = glGetUniformLocation(shader, "uColor");
-    unsigned int uUseTexLoc = glGetUniformLocation(shader, "uUseTexture");
-    unsigned int uRoundingLoc = glGetUniformLocation(shader, "uRounding");
+// Queue a UI element: its atlas image when it is textured and the image is in
+// the atlas, otherwise a plain quad in its color
+void BatchUIObject(UIBatch& batch, const TextureAtlas& atlas, const GameObject& obj, const char* image = nullptr) {
+    const AtlasRegion* region = (obj.useTexture && image) ? atlas.find(image) : nullptr;
+    if (!region) region = atlas.white();
+    if (region) batch.add(obj, *region);
+}
 
-    glUniform4f(uColorLoc, obj.r, obj.g, obj.b, obj.a);
-    glUniform1i(uRoundingLoc, roundingMode);
+// Scene and material textures are block compressed; UI images (the default)
+// keep their exact texels
+void configureTextureCooking(TextureCache& textures) {
+    TextureCookOptions compressed;
+    compressed.compression = TEXTURE_COMPRESSION_AUTO;
+    textures.setCookOptions("Resources/Textures/", compressed);
+    textures.setCookOptions("Models/", compressed);
+}
 
-    if (obj.useTexture) {
-        glUniform1i(uUseTexLoc, 1);
-        glActiveTexture(GL_TEXTURE0);
-        glBindTexture(GL_TEXTURE_2D, obj.textureId);
-    }
-    else {
-        glUniform1i(uUseTexLoc, 0);
+// Cook every PNG/JPEG image in the given directories (not recursive) with the
+// options configured in textures; false if any failed
+bool cookTextureDirectories(const TextureCache& textures, const std::vector<std::string>& directories) {
+    int cooked = 0;
+    int failed = 0;
+    for (const std::string& directory : directories) {
+        std::error_code error;
+        for (const auto& entry : std::filesystem::directory_iterator(directory, error)) {
+            std::string extension = entry.path().extension().string();
+            for (char& c : extension) c = (char)tolower((unsigned char)c);
+            if (!entry.is_regular_file() || (extension != ".png" && extension != ".jpg" && extension != ".jpeg")) continue;
+
+            std::string path = entry.path().generic_string();
+            if (cookTexture(path.c_str(), textures.getCookOptions(path.c_str()))) {
+                std::cout << "Cooked " << path << " -> " << cookedTexturePath(path.c_str()) << std::endl;
+                cooked++;
+            }
+            else {
+                std::cout << "ERROR: Could not cook texture: " << path << std::endl;
+                failed++;
+            }
+        }
+        if (error) std::cout << "ERROR: Could not read directory: " << directory << std::endl;
     }
-
-    glBindVertexArray(VAO);
-    glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
-    glBindVertexArray(0);
+    std::cout << "Cooked " << cooked << " textures, " << failed << " failed" << std::endl;
+    return failed == 0;
 }
 
 void error_callback(int error, const char* description)
@@ -220,8 +214,21 @@ void error_callback(int error, const char* description)
     fprintf(stderr, "GLFW Error: %s\n", description);
 }
 
-int main()
+int main(int argc, char** argv)
 {
+    // Kostur.exe --bench-obj Models/Komplet.obj : print OBJ parser timings and exit
+    if (argc == 3 && std::string(argv[1]) == "--bench-obj") {
+        benchmarkOBJParser(argv[2]);
+        return 0;
+    }
+
+    // Kostur.exe --cook-textures : write the cooked texture of every image in Resources/ and Resources/Textures/ and exit
+    if (argc == 2 && std::string(argv[1]) == "--cook-textures") {
+        TextureCache textures;
+        configureTextureCooking(textures);
+        return cookTextureDirectories(textures, { "Resources", "Resources/Textures" }) ? 0 : 1;
+    }
+
     glfwSetErrorCallback(error_callback);
     if (!glfwInit()) return endProgram("GLFW nije uspeo da se inicijalizuje.");
 
@@ -253,7 +260,18 @@ int main()
     glFrontFace(GL_CCW);
     glClearColor(0.2f, 0.3f, 0.3f, 1.0f);
 
-    unsigned int shaderProgram = createShader("Shaders/basic.vert", "Shaders/basic.frag");
+    // Every variant of the basic shader starts compiling now and is picked up
+    // as it finishes, while the assets below load; a draw only waits for a
+    // variant that is still not done when it first needs it
+    ShaderVariants shaders;
+    if (!shaders.load("Shaders/basic.vert", "Shaders/basic.frag")) {
+        return endProgram("Shaders/basic.vert or Shaders/basic.frag could not be read.");
+    }
+    shaders.setBlockBinding("MaterialBlock", MATERIAL_BLOCK_BINDING);
+    shaders.setBlockBinding("FrameData", FRAME_BLOCK_BINDING);
+    shaders.setBlockBinding("LightData", LIGHT_BLOCK_BINDING);
+    shaders.requestAll();
+    FrameUniforms frameUniforms;
 
     // Updated vertices for 3D (vec3 positions + vec2 texcoords)
     float vertices[] = {
@@ -304,60 +322,80 @@ int main()
     bool f1KeyPressedLastFrame = false;   // For F1 toggle detection
     bool f2KeyPressedLastFrame = false;   // For F2 toggle detection
 
-    unsigned int studentTex = loadImageToTexture("Resources/student_info_sb.png");
+    ModelCache modelCache;  // Create once at startup
+    modelCache.setMemoryBudget(MODEL_MEMORY_BUDGET);
+
+    // Every texture goes through the cache, so an image is only decoded once
+    TextureCache& textures = modelCache.getTextures();
+    configureTextureCooking(textures);
+
+    // The overlay images share one atlas, so the whole UI is a single draw
+    const char* STUDENT_INFO_IMAGE = "Resources/student_info_sb.png";
+    const char* START_BUTTON_IMAGE = "Resources/start.jpg";
+    const char* END_MESSAGE_IMAGE = "Resources/prijatno.png";
+    TextureAtlas uiAtlas;
+    uiAtlas.build({ STUDENT_INFO_IMAGE, START_BUTTON_IMAGE, END_MESSAGE_IMAGE });
+    UIBatch uiBatch;
+
     GameObject studentInfo;
     studentInfo.w = 0.5f; studentInfo.h = 0.3f;
     studentInfo.x = 0.7f; studentInfo.y = 0.8f;
-    studentInfo.useTexture = (studentTex != 0);
-    studentInfo.textureId = studentTex;
+    studentInfo.useTexture = (uiAtlas.find(STUDENT_INFO_IMAGE) != nullptr);
     studentInfo.a = 0.7f;
     if (!studentInfo.useTexture) { studentInfo.r = 0; studentInfo.g = 0; studentInfo.b = 0; }
 
-    ModelCache modelCache;  // Create once at startup
+    // Models and textures are registered with the state that first needs them.
+    // Only MENU loads before the first frame; every later state loads in the
+    // background while the one before it is running.
+    AssetManifest assets(modelCache);
+
+    // Gameplay colors are slots in the shared material table; objects reference them by index
+    MaterialLibrary& materials = modelCache.getMaterials();
+    RenderQueue sceneQueue;
 
     // --- STATE PROMENLJIVE ---
     GameState currentState = MENU;
 
-    // Load start button texture
-    unsigned int startButtonTex = loadImageToTexture("Resources/start.jpg");
+    // Start button (image from the UI atlas)
     GameObject btnOrder;
     btnOrder.w = 0.4f; btnOrder.h = 0.3f;
     btnOrder.x = 0.0f; btnOrder.y = 0.0f;  // Center the button
-    btnOrder.useTexture = (startButtonTex != 0);
-    btnOrder.textureId = startButtonTex;
+    btnOrder.useTexture = (uiAtlas.find(START_BUTTON_IMAGE) != nullptr);
     if (!btnOrder.useTexture) {
         // Fallback color if texture fails to load
         btnOrder.r = 0.9f; btnOrder.g = 0.6f; btnOrder.b = 0.1f;
     }
 
     // 3D Grill model for COOKING state
-    unsigned int grillVAO = loadOBJModel("Models/GrillTop.obj", modelCache);
+    ModelHandle grillModel = assets.addModel(COOKING, "Models/GrillTop.obj");
     GameObject grill;
     grill.is3DModel = true;
-    grill.modelVAO = grillVAO;
-    grill.modelPath = "Models/GrillTop.obj";
+    grill.model = grillModel;
     grill.x = 0.0f;
     grill.y = -0.5f;  // LOWERED from 0.0f to match table height
     grill.z = 0.0f;
     grill.w = 0.2f;  // Visual model scale
     grill.h = 0.2f;
     grill.d = 0.2f;
+    // Gray until the metal texture is loaded (and for good if it fails)
+    grill.r = 0.5f;
+    grill.g = 0.5f;
+    grill.b = 0.5f;
+    // GrillTop.mtl is not shipped, so the grill gets a material of its own
+    grill.materialIndex = materials.addColor("Grill", grill.r, grill.g, grill.b);
     // Apply metal texture to grill top
-    unsigned int metalTex = loadImageToTexture("Resources/Textures/metal.jpg");
-    grill.useTexture = (metalTex != 0);
-    grill.textureId = metalTex;
-    if (!grill.useTexture) {
-        grill.r = 0.5f;  // Fallback gray color if texture fails
-        grill.g = 0.5f;
-        grill.b = 0.5f;
-    }
+    assets.addTexture(COOKING, "Resources/Textures/metal.jpg", [&](unsigned int metalTex) {
+        if (metalTex == 0) return;
+        grill.useTexture = true;
+        grill.textureId = metalTex;
+        materials.setDiffuse(grill.materialIndex, 1.0f, 1.0f, 1.0f, 1.0f);
+    });
 
     // Detailed 3D Grill model (visual only, under the grill top)
-    unsigned int detailedGrillVAO = loadOBJModel("Models/Grill.obj", modelCache);
+    ModelHandle detailedGrillModel = assets.addModel(COOKING, "Models/Grill.obj");
     GameObject detailedGrill;
     detailedGrill.is3DModel = true;
-    detailedGrill.modelVAO = detailedGrillVAO;
-    detailedGrill.modelPath = "Models/Grill.obj";
+    detailedGrill.model = detailedGrillModel;
     detailedGrill.x = 0.0f;
     detailedGrill.y = -0.5f;  // LOWERED from 0.0f to match table height
     detailedGrill.z = 0.0f;
@@ -367,6 +405,8 @@ int main()
     detailedGrill.r = 0.8f;  // gray color
     detailedGrill.g = 0.8f;
     detailedGrill.b = 0.8f;
+    // Same for Grill.mtl
+    detailedGrill.materialIndex = materials.addColor("DetailedGrill", detailedGrill.r, detailedGrill.g, detailedGrill.b);
 
     // Invisible cooking zone (separate from visual grill)
     GameObject cookingZone;
@@ -380,11 +420,10 @@ int main()
     cookingZone.d = 0.9f;  // Deeper cooking area (adjust this)
 
     // Room and floor
-    unsigned int roomVAO = loadOBJModel("Models/Room.obj", modelCache);
+    ModelHandle roomModel = assets.addModel(COOKING, "Models/Room.obj");
     GameObject room;
     room.is3DModel = true;
-    room.modelVAO = roomVAO;
-    room.modelPath = "Models/Room.obj";
+    room.model = roomModel;
     room.x = 0.0f;
     room.y = -0.55f;
     room.z = 0.0f;
@@ -395,11 +434,10 @@ int main()
     room.g = 0.9f;
     room.b = 0.9f;
 
-    unsigned int floorVAO = loadOBJModel("Models/Floor.obj", modelCache);
+    ModelHandle floorModel = assets.addModel(COOKING, "Models/Floor.obj");
     GameObject floorObj;
     floorObj.is3DModel = true;
-    floorObj.modelVAO = floorVAO;
-    floorObj.modelPath = "Models/Room.obj";
+    floorObj.model = floorModel;
     floorObj.x = 0.0f;
     floorObj.y = -0.55f;
     floorObj.z = 0.0f;
@@ -411,11 +449,10 @@ int main()
     floorObj.b = 0.4f;
 
     // 3D Patty model for COOKING state
-    unsigned int pattyVAO = loadOBJModel("Models/Patty.obj", modelCache);
+    ModelHandle pattyModel = assets.addModel(COOKING, "Models/Patty.obj");
     GameObject rawPatty;
     rawPatty.is3DModel = true;
-    rawPatty.modelVAO = pattyVAO;
-    rawPatty.modelPath = "Models/Patty.obj";
+    rawPatty.model = pattyModel;
     rawPatty.x = 0.0f;
     rawPatty.y = 0.4f;
     rawPatty.z = 0.0f;
@@ -437,11 +474,10 @@ int main()
     float cookingProgress = 0.0f;
 
     // 3D Table model (visible in COOKING and ASSEMBLY states)
-    unsigned int tableVAO = loadOBJModel("Models/Table.obj", modelCache);
+    ModelHandle tableModel = assets.addModel(COOKING, "Models/Table.obj");
     GameObject table;
     table.is3DModel = true;
-    table.modelVAO = tableVAO;
-    table.modelPath = "Models/Table.obj";
+    table.model = tableModel;
     table.x = 0.0f;
     table.y = -0.5f;  // LOWERED from 0.0f to match ingredient export height
     table.z = 0.0f;
@@ -490,11 +526,10 @@ int main()
     // ========================================
 
     // 3D Plate model for ASSEMBLY state
-    unsigned int plateVAO = loadOBJModel("Models/Plate.obj", modelCache);
+    ModelHandle plateModel = assets.addModel(ASSEMBLY, "Models/Plate.obj");
     GameObject plate;
     plate.is3DModel = true;
-    plate.modelVAO = plateVAO;
-    plate.modelPath = "Models/Plate.obj";
+    plate.model = plateModel;
     plate.x = 0.0f;
     plate.y = -0.42f;  // LOWERED from 0.0f to match table
     plate.z = 0.0f;
@@ -539,23 +574,23 @@ int main()
     std::vector<Ingredient> ingredients;
     
     // Load 3D models for all ingredients
-    unsigned int bunBotVAO = loadOBJModel("Models/BottomBun.obj", modelCache);
-    unsigned int pattyModelVAO = loadOBJModel("Models/Patty.obj", modelCache);
-    unsigned int ketchupBottleVAO = loadOBJModel("Models/KetchupBottle.obj", modelCache);
-    unsigned int mustardBottleVAO = loadOBJModel("Models/MustardBottle.obj", modelCache);
-    unsigned int picklesVAO = loadOBJModel("Models/Pickles.obj", modelCache);
-    unsigned int onionVAO = loadOBJModel("Models/Onion.obj", modelCache);
-    unsigned int lettuceVAO = loadOBJModel("Models/Lettuce.obj", modelCache);
-    unsigned int cheeseVAO = loadOBJModel("Models/Cheese.obj", modelCache);
-    unsigned int tomatoVAO = loadOBJModel("Models/Tomato.obj", modelCache);
-    unsigned int bunTopVAO = loadOBJModel("Models/TopBun.obj", modelCache);
+    ModelHandle bunBotModel = assets.addModel(ASSEMBLY, "Models/BottomBun.obj");
+    ModelHandle pattyIngredientModel = assets.addModel(ASSEMBLY, "Models/Patty.obj");
+    ModelHandle ketchupBottleModel = assets.addModel(ASSEMBLY, "Models/KetchupBottle.obj");
+    ModelHandle mustardBottleModel = assets.addModel(ASSEMBLY, "Models/MustardBottle.obj");
+    ModelHandle picklesModel = assets.addModel(ASSEMBLY, "Models/Pickles.obj");
+    ModelHandle onionModel = assets.addModel(ASSEMBLY, "Models/Onion.obj");
+    ModelHandle lettuceModel = assets.addModel(ASSEMBLY, "Models/Lettuce.obj");
+    ModelHandle cheeseModel = assets.addModel(ASSEMBLY, "Models/Cheese.obj");
+    ModelHandle tomatoModel = assets.addModel(ASSEMBLY, "Models/Tomato.obj");
+    ModelHandle bunTopModel = assets.addModel(ASSEMBLY, "Models/TopBun.obj");
     
     // Load actual ketchup/mustard models (not bottles - these go ON the burger)
-    unsigned int ketchupVAO = loadOBJModel("Models/Ketchup.obj", modelCache);
-    unsigned int mustardVAO = loadOBJModel("Models/Mustard.obj", modelCache);
+    ModelHandle ketchupModel = assets.addModel(ASSEMBLY, "Models/Ketchup.obj");
+    ModelHandle mustardModel = assets.addModel(ASSEMBLY, "Models/Mustard.obj");
 
     // Helper function to create 3D ingredient
-    auto addIngredient3D = [&](std::string name, unsigned int vao, std::string modelPath,
+    auto addIngredient3D = [&](std::string name, ModelHandle model,
                                float r, float g, float b, IngredientType type,
                                float minHeight, float stackHeight) {
         Ingredient ing;
@@ -566,8 +601,7 @@ int main()
         ing.stackSnapHeight = stackHeight; // ADJUST: Height offset when stacking
         
         ing.obj.is3DModel = true;
-        ing.obj.modelVAO = vao;
-        ing.obj.modelPath = modelPath;
+        ing.obj.model = model;
         ing.obj.x = 0.0f;
         ing.obj.y = 0.5f;  // Start lower - was 1.5f
         ing.obj.z = 0.0f;
@@ -582,32 +616,39 @@ int main()
     };
     
     // Add all ingredients with their 3D models
-    addIngredient3D("BunBot", bunBotVAO, "Models/BottomBun.obj", 0.85f, 0.65f, 0.3f, SOLID, -0.4f, 0.00f);
-    addIngredient3D("Patty", pattyModelVAO, "Models/Patty.obj", 0.5f, 0.25f, 0.0f, SOLID, -0.4f, 0.00f);
-    addIngredient3D("Ketchup", ketchupBottleVAO, "Models/KetchupBottle.obj", 0.8f, 0.1f, 0.1f, SAUCE, -0.16f, 0.0f);
-    addIngredient3D("Mustard", mustardBottleVAO, "Models/MustardBottle.obj", 0.9f, 0.8f, 0.1f, SAUCE, -0.16f, 0.0f);
-    addIngredient3D("Pickles", picklesVAO, "Models/Pickles.obj", 0.2f, 0.6f, 0.2f, SOLID, -0.4f, 0.0f);
-    addIngredient3D("Onion", onionVAO, "Models/Onion.obj", 0.95f, 0.9f, 0.85f, SOLID, -0.4f, 0.0f);
-    addIngredient3D("Lettuce", lettuceVAO, "Models/Lettuce.obj", 0.3f, 0.8f, 0.3f, SOLID, -0.4f, 0.0f);
-    addIngredient3D("Cheese", cheeseVAO, "Models/Cheese.obj", 1.0f, 0.8f, 0.2f, SOLID, -0.4f, 0.00f);
-    addIngredient3D("Tomato", tomatoVAO, "Models/Tomato.obj", 0.9f, 0.2f, 0.2f, SOLID, -0.4f, 0.0f);
-    addIngredient3D("BunTop", bunTopVAO, "Models/TopBun.obj", 0.85f, 0.65f, 0.3f, SOLID, -0.4f, 0.0f);
+    addIngredient3D("BunBot", bunBotModel, 0.85f, 0.65f, 0.3f, SOLID, -0.4f, 0.00f);
+    addIngredient3D("Patty", pattyIngredientModel, 0.5f, 0.25f, 0.0f, SOLID, -0.4f, 0.00f);
+    addIngredient3D("Ketchup", ketchupBottleModel, 0.8f, 0.1f, 0.1f, SAUCE, -0.16f, 0.0f);
+    addIngredient3D("Mustard", mustardBottleModel, 0.9f, 0.8f, 0.1f, SAUCE, -0.16f, 0.0f);
+    addIngredient3D("Pickles", picklesModel, 0.2f, 0.6f, 0.2f, SOLID, -0.4f, 0.0f);
+    addIngredient3D("Onion", onionModel, 0.95f, 0.9f, 0.85f, SOLID, -0.4f, 0.0f);
+    addIngredient3D("Lettuce", lettuceModel, 0.3f, 0.8f, 0.3f, SOLID, -0.4f, 0.0f);
+    addIngredient3D("Cheese", cheeseModel, 1.0f, 0.8f, 0.2f, SOLID, -0.4f, 0.00f);
+    addIngredient3D("Tomato", tomatoModel, 0.9f, 0.2f, 0.2f, SOLID, -0.4f, 0.0f);
+    addIngredient3D("BunTop", bunTopModel, 0.85f, 0.65f, 0.3f, SOLID, -0.4f, 0.0f);
 
     int currentIngredientIndex = 0;
     std::vector<GameObject> puddles;
     
     // Load splat textures for sauce failures
-    unsigned int ketchupSplatTex = loadImageToTexture("Resources/Textures/KetchupSplat.png");
-    unsigned int mustardSplatTex = loadImageToTexture("Resources/Textures/MustardSplat.png");
+    unsigned int ketchupSplatTex = 0;
+    unsigned int mustardSplatTex = 0;
+    assets.addTexture(ASSEMBLY, "Resources/Textures/KetchupSplat.png", [&](unsigned int tex) { ketchupSplatTex = tex; });
+    assets.addTexture(ASSEMBLY, "Resources/Textures/MustardSplat.png", [&](unsigned int tex) { mustardSplatTex = tex; });
 
     // End message for FINISHED state
     GameObject endMessage;
     endMessage.w = 0.4f; endMessage.h = 0.2f;
     endMessage.x = 0.0f; endMessage.y = 0.2f;
-    endMessage.useTexture = true;
-    unsigned int msgTex = loadImageToTexture("Resources/prijatno.png");
-    if (msgTex) endMessage.textureId = msgTex;
-    else { endMessage.r = 0; endMessage.g = 0; endMessage.b = 1; endMessage.useTexture = false; }
+    endMessage.useTexture = (uiAtlas.find(END_MESSAGE_IMAGE) != nullptr);
+    if (!endMessage.useTexture) { endMessage.r = 0; endMessage.g = 0; endMessage.b = 1; }
+
+    // The menu needs only the UI textures loaded above; COOKING starts loading
+    // in the background with the first update()
+    assets.loadStage(MENU);
+
+    // glfwGetTime counts from glfwInit, so this is the cold-start cost of context + asset loading
+    std::cout << "Startup finished in " << glfwGetTime() * 1000.0 << " ms" << std::endl;
 
 // Main game loop
     double lastTime = glfwGetTime();
@@ -621,6 +662,12 @@ int main()
         lastTime = now;
 
         glfwPollEvents();
+
+        // Stream in the next state's assets
+        assets.update(currentState);
+        // Take over the shader variants the driver finished compiling
+        shaders.poll();
+
         if (glfwGetKey(window, GLFW_KEY_ESCAPE) == GLFW_PRESS)
             glfwSetWindowShouldClose(window, true);
 
@@ -777,17 +824,14 @@ int main()
                     // Check if it's ketchup or mustard BOTTLE being used
                     if (curr.name == "Ketchup" || curr.name == "Mustard") {
                         unsigned int splatTexture = 0;
-                        unsigned int sauceModelVAO = 0;
-                        std::string sauceModelPath = "";
+                        ModelHandle sauceModel = INVALID_MODEL;
                         
                         if (curr.name == "Ketchup") {
                             splatTexture = ketchupSplatTex;
-                            sauceModelVAO = ketchupVAO;
-                            sauceModelPath = "Models/Ketchup.obj";
+                            sauceModel = ketchupModel;
                         } else {
                             splatTexture = mustardSplatTex;
-                            sauceModelVAO = mustardVAO;
-                            sauceModelPath = "Models/Mustard.obj";
+                            sauceModel = mustardModel;
                         }
                         
                         // Check zones using XZ-only collision (height doesn't matter)
@@ -798,8 +842,7 @@ int main()
                             // Bottle is above the burger - place sauce MODEL on the stack
                             GameObject sauceLayer;
                             sauceLayer.is3DModel = true;
-                            sauceLayer.modelVAO = sauceModelVAO;
-                            sauceLayer.modelPath = sauceModelPath;
+                            sauceLayer.model = sauceModel;
                             sauceLayer.x = plate.x;
                             sauceLayer.y = stackHeight;  // Place at current stack height
                             sauceLayer.z = plate.z;
@@ -822,8 +865,7 @@ int main()
                             // Create 3D sauce model splat on table (rotated randomly)
                             GameObject splat;
                             splat.is3DModel = true;
-                            splat.modelVAO = sauceModelVAO;
-                            splat.modelPath = sauceModelPath;
+                            splat.model = sauceModel;
                             splat.x = curr.obj.x;
                             splat.y = tableZone.y - 0.14f;  // Place directly on table surface (not above)
                             splat.z = curr.obj.z;
@@ -843,8 +885,7 @@ int main()
                             // Create 3D sauce model splat on floor (same as table, but on floor)
                             GameObject splat;
                             splat.is3DModel = true;
-                            splat.modelVAO = sauceModelVAO;
-                            splat.modelPath = sauceModelPath;
+                            splat.model = sauceModel;
                             splat.x = curr.obj.x;
                             splat.y = floorZone.y;  // Place directly on floor surface
                             splat.z = curr.obj.z;
@@ -875,8 +916,16 @@ int main()
 
         // --- RENDER LOGIKA ---
         
-        // === PASS LIGHT UNIFORMS TO SHADER ===
-        setLightUniforms(shaderProgram, sceneLight, camera);
+        // === PER-FRAME UNIFORMS ===
+        // Camera and light of both passes go to the GPU once; draws only set their own model and material
+        Light uiLight = sceneLight;
+        uiLight.enabled = false;  // UI elements are full brightness
+        frameUniforms.setCamera(FRAME_PASS_SCENE, camera.getViewMatrix(), camera.getProjectionMatrix(aspectRatio), camera.position);
+        frameUniforms.setLight(FRAME_PASS_SCENE, sceneLight);
+        frameUniforms.setCamera(FRAME_PASS_UI, camera.getUIViewMatrix(), camera.getOrthoProjectionMatrix(), camera.position);
+        frameUniforms.setLight(FRAME_PASS_UI, uiLight);
+        frameUniforms.upload();
+        frameUniforms.bind(FRAME_PASS_SCENE);
         
         // === RENDER 3D SCENE (with depth testing) ===
         // Apply depth testing state (controlled by F2 key)
@@ -891,23 +940,23 @@ int main()
         }
         else if (currentState == COOKING) {
             // Render 3D grill and patty
-            RenderObject3D(shaderProgram, VAO, table, camera, aspectRatio, modelCache);
-            RenderObject3D(shaderProgram, VAO, floorObj, camera, aspectRatio, modelCache);
-            RenderObject3D(shaderProgram, VAO, room, camera, aspectRatio, modelCache);
-            RenderObject3D(shaderProgram, VAO, detailedGrill, camera, aspectRatio, modelCache);
-            RenderObject3D(shaderProgram, VAO, grill, camera, aspectRatio, modelCache);
-            RenderObject3D(shaderProgram, VAO, rawPatty, camera, aspectRatio, modelCache);
+            sceneQueue.submit(table);
+            sceneQueue.submit(floorObj);
+            sceneQueue.submit(room);
+            sceneQueue.submit(detailedGrill);
+            sceneQueue.submit(grill);
+            sceneQueue.submit(rawPatty);
         }
         else if (currentState == ASSEMBLY) {
             // Render 3D table and plate
-            RenderObject3D(shaderProgram, VAO, table, camera, aspectRatio, modelCache);
-            RenderObject3D(shaderProgram, VAO, plate, camera, aspectRatio, modelCache);
-            RenderObject3D(shaderProgram, VAO, floorObj, camera, aspectRatio, modelCache);
-            RenderObject3D(shaderProgram, VAO, room, camera, aspectRatio, modelCache);
+            sceneQueue.submit(table);
+            sceneQueue.submit(plate);
+            sceneQueue.submit(floorObj);
+            sceneQueue.submit(room);
 
             // Render splat puddles (both 3D models on table and floor)
             for (auto& p : puddles) {
-                RenderObject3D(shaderProgram, VAO, p, camera, aspectRatio, modelCache);
+                sceneQueue.submit(p);
             }
 
             // Calculate current stack height for placement
@@ -931,21 +980,21 @@ int main()
                     }
                 }
                 
-                RenderObject3D(shaderProgram, VAO, stackedObj, camera, aspectRatio, modelCache);
+                sceneQueue.submit(stackedObj);
             }
 
             // Render current ingredient being placed
             if (currentIngredientIndex < ingredients.size()) {
                 Ingredient& curr = ingredients[currentIngredientIndex];
-                RenderObject3D(shaderProgram, VAO, curr.obj, camera, aspectRatio, modelCache);
+                sceneQueue.submit(curr.obj);
             }
         }
         else if (currentState == FINISHED) {
             // Render 3D table and plate
-            RenderObject3D(shaderProgram, VAO, table, camera, aspectRatio, modelCache);
-            RenderObject3D(shaderProgram, VAO, plate, camera, aspectRatio, modelCache);
-            RenderObject3D(shaderProgram, VAO, floorObj, camera, aspectRatio, modelCache);
-            RenderObject3D(shaderProgram, VAO, room, camera, aspectRatio, modelCache);
+            sceneQueue.submit(table);
+            sceneQueue.submit(plate);
+            sceneQueue.submit(floorObj);
+            sceneQueue.submit(room);
             
             // Render final burger stack
             float stackY = plateZone.y + 0.02f;
@@ -955,41 +1004,46 @@ int main()
                 stackedObj.z = plate.z;
                 stackedObj.y = stackY;
                 
-                RenderObject3D(shaderProgram, VAO, stackedObj, camera, aspectRatio, modelCache);
+                sceneQueue.submit(stackedObj);
                 stackY += ing.stackSnapHeight;
             }
         }
-        // Disable lighting for UI elements (they should be full brightness)
-        Light uiLight = sceneLight;
-        uiLight.enabled = false;
-        setLightUniforms(shaderProgram, uiLight, camera);
+        // Draw the queued 3D scene sorted by shader variant and material
+        uint32_t sceneFeatures = sceneLight.enabled ? SHADER_LIT : 0u;
+        sceneQueue.flush(shaders, sceneFeatures, VAO, camera, aspectRatio, modelCache);
+        modelCache.endFrame();
+
+        // Switch to the unlit UI camera
+        frameUniforms.bind(FRAME_PASS_UI);
         // === RENDER 2D UI OVERLAY (without depth testing) ===
         glDisable(GL_DEPTH_TEST);
 
         // Student info overlay (always visible)
-        RenderUIObject(shaderProgram, VAO, studentInfo, camera);
+        BatchUIObject(uiBatch, uiAtlas, studentInfo, STUDENT_INFO_IMAGE);
 
         if (currentState == MENU) {
             // Menu button
-            RenderUIObject(shaderProgram, VAO, btnOrder, camera);
+            BatchUIObject(uiBatch, uiAtlas, btnOrder, START_BUTTON_IMAGE);
         }
         else if (currentState == COOKING) {
             // Loading bar
-            RenderUIObject(shaderProgram, VAO, loadingBarBorder, camera);
+            BatchUIObject(uiBatch, uiAtlas, loadingBarBorder);
             loadingBarFill.x = loadingBarBorder.x - loadingBarBorder.w / 2 + loadingBarFill.w / 2 + 0.01f;
-            RenderUIObject(shaderProgram, VAO, loadingBarFill, camera);
+            BatchUIObject(uiBatch, uiAtlas, loadingBarFill);
         }
         else if (currentState == FINISHED) {
             // End message
-            RenderUIObject(shaderProgram, VAO, endMessage, camera);
+            BatchUIObject(uiBatch, uiAtlas, endMessage, END_MESSAGE_IMAGE);
         }
+        uiBatch.flush(shaders, uiAtlas);
 
         glfwSwapBuffers(window);
     }
 
     glDeleteVertexArrays(1, &VAO);
     glDeleteBuffers(1, &VBO);
-    glDeleteProgram(shaderProgram);
+    shaders.destroy();
+    frameUniforms.destroy();
 
     glfwDestroyWindow(window);
     glfwTerminate();
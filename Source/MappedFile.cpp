@@ -0,0 +1,102 @@
+#include "../Header/MappedFile.h"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#ifdef _WIN32
+
+MappedFile::MappedFile() : bytes(nullptr), length(0), fileHandle(nullptr), mappingHandle(nullptr) {}
+
+bool MappedFile::open(const char* filepath) {
+    close();
+
+    HANDLE file = CreateFileA(filepath, GENERIC_READ, FILE_SHARE_READ, NULL,
+                              OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+    if (file == INVALID_HANDLE_VALUE) return false;
+
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart == 0) {
+        CloseHandle(file);
+        return false;
+    }
+
+    HANDLE mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+    if (mapping == NULL) {
+        CloseHandle(file);
+        return false;
+    }
+
+    void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    if (view == NULL) {
+        CloseHandle(mapping);
+        CloseHandle(file);
+        return false;
+    }
+
+    fileHandle = file;
+    mappingHandle = mapping;
+    bytes = static_cast<const char*>(view);
+    length = static_cast<size_t>(fileSize.QuadPart);
+    return true;
+}
+
+void MappedFile::close() {
+    if (bytes) UnmapViewOfFile(bytes);
+    if (mappingHandle) CloseHandle(mappingHandle);
+    if (fileHandle) CloseHandle(fileHandle);
+    bytes = nullptr;
+    length = 0;
+    fileHandle = nullptr;
+    mappingHandle = nullptr;
+}
+
+#else
+
+MappedFile::MappedFile() : bytes(nullptr), length(0), fd(-1) {}
+
+bool MappedFile::open(const char* filepath) {
+    close();
+
+    int file = ::open(filepath, O_RDONLY);
+    if (file < 0) return false;
+
+    struct stat st;
+    if (fstat(file, &st) != 0 || st.st_size == 0) {
+        ::close(file);
+        return false;
+    }
+
+    void* view = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_PRIVATE, file, 0);
+    if (view == MAP_FAILED) {
+        ::close(file);
+        return false;
+    }
+    madvise(view, static_cast<size_t>(st.st_size), MADV_SEQUENTIAL);
+
+    fd = file;
+    bytes = static_cast<const char*>(view);
+    length = static_cast<size_t>(st.st_size);
+    return true;
+}
+
+void MappedFile::close() {
+    if (bytes) munmap(const_cast<char*>(bytes), length);
+    if (fd >= 0) ::close(fd);
+    bytes = nullptr;
+    length = 0;
+    fd = -1;
+}
+
+#endif
+
+MappedFile::~MappedFile() {
+    close();
+}
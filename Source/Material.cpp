@@ -0,0 +1,227 @@
+#include "../Header/Material.h"
+#include <charconv>
+#include <cstring>
+#include <iostream>
+
+MaterialDesc::MaterialDesc() : shininess(32.0f), alpha(1.0f) {
+    diffuse[0] = diffuse[1] = diffuse[2] = 1.0f;
+    specular[0] = specular[1] = specular[2] = 0.5f;
+}
+
+namespace {
+
+inline bool isSpace(char c) {
+    return c == ' ' || c == '\t' || c == '\r';
+}
+
+inline const char* skipSpaces(const char* p, const char* end) {
+    while (p < end && isSpace(*p)) p++;
+    return p;
+}
+
+inline const char* parseFloat(const char* p, const char* end, float& value) {
+    p = skipSpaces(p, end);
+    if (p < end && *p == '+') p++;
+    std::from_chars_result result = std::from_chars(p, end, value);
+    return result.ptr;
+}
+
+// True if the line at p starts with the keyword; p is moved past it
+inline bool keyword(const char*& p, const char* lineEnd, const char* word) {
+    size_t length = std::strlen(word);
+    if ((size_t)(lineEnd - p) <= length || std::memcmp(p, word, length) != 0 || !isSpace(p[length])) return false;
+    p += length;
+    return true;
+}
+
+inline std::string restOfLine(const char* p, const char* lineEnd) {
+    p = skipSpaces(p, lineEnd);
+    const char* nameEnd = lineEnd;
+    while (nameEnd > p && isSpace(nameEnd[-1])) nameEnd--;
+    return std::string(p, nameEnd);
+}
+
+// Directory part of a path including the trailing slash ("Models/Patty.mtl" -> "Models/")
+std::string directoryOf(const std::string& path) {
+    size_t slash = path.find_last_of("/\\");
+    return slash == std::string::npos ? std::string() : path.substr(0, slash + 1);
+}
+
+} // namespace
+
+void parseMTL(const char* data, size_t size, std::vector<MaterialDesc>& out) {
+    const char* end = data + size;
+    MaterialDesc* current = nullptr;
+
+    for (const char* p = data; p < end; ) {
+        const char* lineEnd = p;
+        while (lineEnd < end && *lineEnd != '\n') lineEnd++;
+        p = skipSpaces(p, lineEnd);
+
+        if (keyword(p, lineEnd, "newmtl")) {
+            out.emplace_back();
+            current = &out.back();
+            current->name = restOfLine(p, lineEnd);
+        }
+        else if (current) {
+            if (keyword(p, lineEnd, "Kd")) {
+                p = parseFloat(p, lineEnd, current->diffuse[0]);
+                p = parseFloat(p, lineEnd, current->diffuse[1]);
+                parseFloat(p, lineEnd, current->diffuse[2]);
+            }
+            else if (keyword(p, lineEnd, "Ks")) {
+                p = parseFloat(p, lineEnd, current->specular[0]);
+                p = parseFloat(p, lineEnd, current->specular[1]);
+                parseFloat(p, lineEnd, current->specular[2]);
+            }
+            else if (keyword(p, lineEnd, "Ns")) {
+                parseFloat(p, lineEnd, current->shininess);
+            }
+            else if (keyword(p, lineEnd, "d")) {
+                parseFloat(p, lineEnd, current->alpha);
+            }
+            else if (keyword(p, lineEnd, "map_Kd")) {
+                // Options such as -s or -o are not supported; the file name is the last token
+                std::string map = restOfLine(p, lineEnd);
+                size_t space = map.find_last_of(" \t");
+                current->diffuseMap = (space == std::string::npos) ? map : map.substr(space + 1);
+            }
+        }
+
+        p = lineEnd < end ? lineEnd + 1 : end;
+    }
+}
+
+MaterialLibrary::MaterialLibrary(TextureCache& textures) : textures(textures), ubo(0), dirtyBegin(0), dirtyEnd(0) {
+    clear();
+}
+
+uint32_t MaterialLibrary::addSlot(const std::string& key, const GpuMaterial& material, const std::string& diffuseMap) {
+    auto it = lookup.find(key);
+    if (it != lookup.end()) return it->second;
+
+    if (materials.size() >= MAX_MATERIALS) {
+        std::cout << "ERROR: Material table is full, using the default for " << key << std::endl;
+        return 0;
+    }
+
+    uint32_t index = (uint32_t)materials.size();
+    materials.push_back(material);
+    diffuseMaps.push_back(diffuseMap);
+    diffuseTextures.push_back(INVALID_TEXTURE);
+    lookup[key] = index;
+    markDirty(index);
+    return index;
+}
+
+void MaterialLibrary::markDirty(uint32_t index) {
+    if (dirtyBegin == dirtyEnd) {
+        dirtyBegin = index;
+        dirtyEnd = index + 1;
+    }
+    else {
+        if (index < dirtyBegin) dirtyBegin = index;
+        if (index + 1 > dirtyEnd) dirtyEnd = index + 1;
+    }
+}
+
+uint32_t MaterialLibrary::addMaterial(const std::string& mtlPath, const MaterialDesc& desc) {
+    GpuMaterial material;
+    material.diffuse[0] = desc.diffuse[0];
+    material.diffuse[1] = desc.diffuse[1];
+    material.diffuse[2] = desc.diffuse[2];
+    material.diffuse[3] = desc.alpha;
+    material.specular[0] = desc.specular[0];
+    material.specular[1] = desc.specular[1];
+    material.specular[2] = desc.specular[2];
+    material.specular[3] = desc.shininess;
+
+    // Ns 0 (what Blender writes for fully rough materials) would turn pow() into
+    // a constant and light the whole surface; treat it as no highlight instead
+    if (desc.shininess < 1.0f) {
+        material.specular[0] = material.specular[1] = material.specular[2] = 0.0f;
+        material.specular[3] = 1.0f;
+    }
+
+    std::string diffuseMap = desc.diffuseMap.empty() ? std::string() : directoryOf(mtlPath) + desc.diffuseMap;
+    return addSlot(mtlPath + ":" + desc.name, material, diffuseMap);
+}
+
+uint32_t MaterialLibrary::addColor(const std::string& name, float r, float g, float b, float a) {
+    GpuMaterial material = materials[0];
+    material.diffuse[0] = r;
+    material.diffuse[1] = g;
+    material.diffuse[2] = b;
+    material.diffuse[3] = a;
+    return addSlot(name, material, std::string());
+}
+
+void MaterialLibrary::setDiffuse(uint32_t index, float r, float g, float b, float a) {
+    if (index == 0 || index >= materials.size()) return;
+    GpuMaterial& material = materials[index];
+    if (material.diffuse[0] == r && material.diffuse[1] == g && material.diffuse[2] == b && material.diffuse[3] == a) return;
+    material.diffuse[0] = r;
+    material.diffuse[1] = g;
+    material.diffuse[2] = b;
+    material.diffuse[3] = a;
+    markDirty(index);
+}
+
+uint32_t MaterialLibrary::find(const std::string& mtlPath, const std::string& name) const {
+    auto it = lookup.find(mtlPath + ":" + name);
+    return it != lookup.end() ? it->second : 0;
+}
+
+void MaterialLibrary::upload() {
+    if (ubo == 0) {
+        // Allocated at full size once, so adding materials never reallocates
+        glGenBuffers(1, &ubo);
+        glBindBuffer(GL_UNIFORM_BUFFER, ubo);
+        glBufferData(GL_UNIFORM_BUFFER, MAX_MATERIALS * sizeof(GpuMaterial), nullptr, GL_DYNAMIC_DRAW);
+        glBindBufferBase(GL_UNIFORM_BUFFER, MATERIAL_BLOCK_BINDING, ubo);
+        dirtyBegin = 0;
+        dirtyEnd = (uint32_t)materials.size();
+    }
+    if (dirtyBegin == dirtyEnd) return;
+
+    for (uint32_t i = dirtyBegin; i < dirtyEnd; i++) {
+        if (!diffuseMaps[i].empty() && diffuseTextures[i] == INVALID_TEXTURE) {
+            // Loads in the background (white until then); materials sharing an
+            // image share its texture
+            diffuseTextures[i] = textures.request(diffuseMaps[i].c_str());
+        }
+    }
+
+    glBindBuffer(GL_UNIFORM_BUFFER, ubo);
+    glBufferSubData(GL_UNIFORM_BUFFER, dirtyBegin * sizeof(GpuMaterial),
+                    (dirtyEnd - dirtyBegin) * sizeof(GpuMaterial), &materials[dirtyBegin]);
+    glBindBuffer(GL_UNIFORM_BUFFER, 0);
+    dirtyBegin = dirtyEnd = 0;
+}
+
+void MaterialLibrary::clear() {
+    if (ubo != 0) {
+        glDeleteBuffers(1, &ubo);
+        ubo = 0;
+    }
+    for (TextureHandle texture : diffuseTextures) {
+        textures.release(texture);
+    }
+
+    materials.clear();
+    diffuseMaps.clear();
+    diffuseTextures.clear();
+    lookup.clear();
+    dirtyBegin = dirtyEnd = 0;
+
+    // Slot 0: what the shader used for every object before materials existed
+    MaterialDesc defaults;
+    GpuMaterial material;
+    material.diffuse[0] = material.diffuse[1] = material.diffuse[2] = material.diffuse[3] = 1.0f;
+    material.specular[0] = material.specular[1] = material.specular[2] = defaults.specular[0];
+    material.specular[3] = defaults.shininess;
+    materials.push_back(material);
+    diffuseMaps.push_back(std::string());
+    diffuseTextures.push_back(INVALID_TEXTURE);
+    lookup[""] = 0;
+}
@@ -0,0 +1,319 @@
+#include "../Header/MeshOptimizer.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+// FIFO post-transform cache: a vertex stays cached until size newer
+// vertices were transformed after it
+struct FifoCache {
+    std::vector<uint32_t> stamp;
+    uint32_t time;
+    uint32_t size;
+
+    FifoCache(size_t vertexCount, size_t cacheSize)
+        : stamp(vertexCount, 0), time((uint32_t)cacheSize + 1), size((uint32_t)cacheSize) {}
+
+    // Returns true on a miss (the vertex had to be transformed)
+    bool access(uint32_t vertex) {
+        if (time - stamp[vertex] > size) {
+            stamp[vertex] = time++;
+            return true;
+        }
+        return false;
+    }
+
+    unsigned int accessTriangle(const uint32_t* triangle) {
+        return access(triangle[0]) + access(triangle[1]) + access(triangle[2]);
+    }
+
+    void reset() {
+        time += size + 1;
+    }
+};
+
+// Forsyth's scoring: recently used vertices score high (the last triangle's a
+// bit less, to avoid strips), vertices with few remaining triangles get a boost
+// so they are finished and leave the working set.
+const size_t FORSYTH_CACHE_SIZE = 32;
+const float CACHE_DECAY_POWER = 1.5f;
+const float LAST_TRIANGLE_SCORE = 0.75f;
+const float VALENCE_BOOST_SCALE = 2.0f;
+const float VALENCE_BOOST_POWER = 0.5f;
+
+float vertexScore(int cachePosition, uint32_t remainingTriangles) {
+    if (remainingTriangles == 0) return -1.0f;
+
+    float score = 0.0f;
+    if (cachePosition >= 0) {
+        if (cachePosition < 3) {
+            score = LAST_TRIANGLE_SCORE;
+        }
+        else {
+            float scale = 1.0f / (FORSYTH_CACHE_SIZE - 3);
+            score = std::pow(1.0f - (cachePosition - 3) * scale, CACHE_DECAY_POWER);
+        }
+    }
+    return score + VALENCE_BOOST_SCALE * std::pow((float)remainingTriangles, -VALENCE_BOOST_POWER);
+}
+
+} // namespace
+
+VertexCacheStats analyzeVertexCache(const uint32_t* indices, size_t indexCount, size_t vertexCount, size_t cacheSize) {
+    VertexCacheStats stats = { 0.0f, 0.0f };
+    size_t triangleCount = indexCount / 3;
+    if (triangleCount == 0) return stats;
+
+    FifoCache cache(vertexCount, cacheSize);
+    std::vector<bool> used(vertexCount, false);
+    size_t misses = 0, uniqueVertices = 0;
+    for (size_t i = 0; i < triangleCount * 3; i++) {
+        misses += cache.access(indices[i]);
+        if (!used[indices[i]]) {
+            used[indices[i]] = true;
+            uniqueVertices++;
+        }
+    }
+
+    stats.acmr = (float)misses / triangleCount;
+    stats.atvr = (float)misses / uniqueVertices;
+    return stats;
+}
+
+void optimizeVertexCache(uint32_t* indices, size_t indexCount, size_t vertexCount) {
+    size_t triangleCount = indexCount / 3;
+    if (triangleCount < 2) return;
+
+    // Triangles using each vertex; emitted triangles are swapped out of the
+    // front part of each list, which holds remaining[v] entries
+    std::vector<uint32_t> offsets(vertexCount + 1, 0);
+    for (size_t i = 0; i < triangleCount * 3; i++) offsets[indices[i] + 1]++;
+    for (size_t v = 0; v < vertexCount; v++) offsets[v + 1] += offsets[v];
+
+    std::vector<uint32_t> adjacency(triangleCount * 3);
+    std::vector<uint32_t> remaining(vertexCount, 0);
+    for (size_t t = 0; t < triangleCount; t++) {
+        for (int k = 0; k < 3; k++) {
+            uint32_t v = indices[t * 3 + k];
+            adjacency[offsets[v] + remaining[v]++] = (uint32_t)t;
+        }
+    }
+
+    std::vector<int> cachePosition(vertexCount, -1);
+    std::vector<float> scores(vertexCount);
+    for (size_t v = 0; v < vertexCount; v++) scores[v] = vertexScore(-1, remaining[v]);
+
+    std::vector<float> triangleScores(triangleCount);
+    size_t best = 0;
+    for (size_t t = 0; t < triangleCount; t++) {
+        const uint32_t* triangle = indices + t * 3;
+        triangleScores[t] = scores[triangle[0]] + scores[triangle[1]] + scores[triangle[2]];
+        if (triangleScores[t] > triangleScores[best]) best = t;
+    }
+
+    std::vector<bool> emitted(triangleCount, false);
+    std::vector<uint32_t> output;
+    output.reserve(triangleCount * 3);
+
+    uint32_t cache[FORSYTH_CACHE_SIZE + 3];
+    size_t cacheCount = 0;
+    size_t scanCursor = 0;
+
+    while (true) {
+        if (best == SIZE_MAX) {
+            // Nothing around the cache is left: continue with the next unused triangle
+            while (scanCursor < triangleCount && emitted[scanCursor]) scanCursor++;
+            if (scanCursor == triangleCount) break;
+            best = scanCursor;
+        }
+
+        emitted[best] = true;
+        const uint32_t* triangle = indices + best * 3;
+        output.insert(output.end(), triangle, triangle + 3);
+
+        for (int k = 0; k < 3; k++) {
+            uint32_t v = triangle[k];
+            uint32_t* list = &adjacency[offsets[v]];
+            for (uint32_t i = 0; i < remaining[v]; i++) {
+                if (list[i] == best) {
+                    std::swap(list[i], list[remaining[v] - 1]);
+                    remaining[v]--;
+                    break;
+                }
+            }
+        }
+
+        // The triangle's vertices move to the front of the LRU cache
+        uint32_t newCache[FORSYTH_CACHE_SIZE + 3];
+        size_t newCount = 0;
+        for (int k = 0; k < 3; k++) {
+            if (std::find(newCache, newCache + newCount, triangle[k]) == newCache + newCount) {
+                newCache[newCount++] = triangle[k];
+            }
+        }
+        for (size_t i = 0; i < cacheCount; i++) {
+            uint32_t v = cache[i];
+            if (v != triangle[0] && v != triangle[1] && v != triangle[2]) newCache[newCount++] = v;
+        }
+
+        for (size_t i = 0; i < newCount; i++) {
+            uint32_t v = newCache[i];
+            cachePosition[v] = i < FORSYTH_CACHE_SIZE ? (int)i : -1;
+            scores[v] = vertexScore(cachePosition[v], remaining[v]);
+        }
+
+        // Rescore the remaining triangles of every vertex whose score changed
+        // (including the ones just evicted) and continue with the best of them
+        best = SIZE_MAX;
+        float bestScore = -1.0f;
+        for (size_t i = 0; i < newCount; i++) {
+            uint32_t v = newCache[i];
+            const uint32_t* list = &adjacency[offsets[v]];
+            for (uint32_t j = 0; j < remaining[v]; j++) {
+                uint32_t t = list[j];
+                const uint32_t* other = indices + t * 3;
+                triangleScores[t] = scores[other[0]] + scores[other[1]] + scores[other[2]];
+                if (triangleScores[t] > bestScore) {
+                    bestScore = triangleScores[t];
+                    best = t;
+                }
+            }
+        }
+
+        cacheCount = std::min(newCount, FORSYTH_CACHE_SIZE);
+        std::copy(newCache, newCache + cacheCount, cache);
+    }
+
+    std::copy(output.begin(), output.end(), indices);
+}
+
+void optimizeOverdraw(uint32_t* indices, size_t indexCount, const std::vector<Vertex>& vertices, float threshold) {
+    size_t triangleCount = indexCount / 3;
+    if (triangleCount < 2) return;
+
+    // Hard boundaries: triangles that miss the cache on all three vertices
+    // already start from a cold cache, so moving them costs nothing
+    std::vector<size_t> hardBoundaries;
+    FifoCache cache(vertices.size(), VERTEX_CACHE_SIZE);
+    for (size_t t = 0; t < triangleCount; t++) {
+        if (cache.accessTriangle(indices + t * 3) == 3) hardBoundaries.push_back(t);
+    }
+    hardBoundaries.push_back(triangleCount);
+
+    // Soft boundaries: split a hard cluster again as soon as the part so far,
+    // simulated from a cold cache, is within threshold of the cluster's ACMR
+    std::vector<size_t> clusters;
+    for (size_t c = 0; c + 1 < hardBoundaries.size(); c++) {
+        size_t begin = hardBoundaries[c], end = hardBoundaries[c + 1];
+
+        cache.reset();
+        size_t misses = 0;
+        for (size_t t = begin; t < end; t++) misses += cache.accessTriangle(indices + t * 3);
+        float limit = (float)misses / (end - begin) * threshold;
+
+        cache.reset();
+        size_t start = begin;
+        misses = 0;
+        clusters.push_back(begin);
+        for (size_t t = begin; t + 1 < end; t++) {
+            misses += cache.accessTriangle(indices + t * 3);
+            if ((float)misses / (t + 1 - start) <= limit) {
+                clusters.push_back(t + 1);
+                cache.reset();
+                start = t + 1;
+                misses = 0;
+            }
+        }
+    }
+    clusters.push_back(triangleCount);
+
+    // Area-weighted centroid and normal of every cluster
+    struct ClusterInfo {
+        size_t begin, end;
+        float centroid[3];
+        float normal[3];
+        float area;
+        float sortKey;
+    };
+    std::vector<ClusterInfo> infos(clusters.size() - 1);
+    float meshCentroid[3] = { 0.0f, 0.0f, 0.0f };
+    float meshArea = 0.0f;
+
+    for (size_t c = 0; c + 1 < clusters.size(); c++) {
+        ClusterInfo& info = infos[c];
+        info = ClusterInfo{ clusters[c], clusters[c + 1], { 0.0f, 0.0f, 0.0f }, { 0.0f, 0.0f, 0.0f }, 0.0f, 0.0f };
+
+        for (size_t t = info.begin; t < info.end; t++) {
+            const Vertex& a = vertices[indices[t * 3 + 0]];
+            const Vertex& b = vertices[indices[t * 3 + 1]];
+            const Vertex& d = vertices[indices[t * 3 + 2]];
+            float e1[3] = { b.x - a.x, b.y - a.y, b.z - a.z };
+            float e2[3] = { d.x - a.x, d.y - a.y, d.z - a.z };
+            float n[3] = { e1[1] * e2[2] - e1[2] * e2[1], e1[2] * e2[0] - e1[0] * e2[2], e1[0] * e2[1] - e1[1] * e2[0] };
+            float area = std::sqrt(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]) * 0.5f;
+
+            info.centroid[0] += (a.x + b.x + d.x) / 3.0f * area;
+            info.centroid[1] += (a.y + b.y + d.y) / 3.0f * area;
+            info.centroid[2] += (a.z + b.z + d.z) / 3.0f * area;
+            info.normal[0] += n[0];
+            info.normal[1] += n[1];
+            info.normal[2] += n[2];
+            info.area += area;
+        }
+
+        for (int axis = 0; axis < 3; axis++) meshCentroid[axis] += info.centroid[axis];
+        meshArea += info.area;
+        if (info.area > 0.0f) {
+            for (int axis = 0; axis < 3; axis++) info.centroid[axis] /= info.area;
+        }
+    }
+    if (meshArea > 0.0f) {
+        for (int axis = 0; axis < 3; axis++) meshCentroid[axis] /= meshArea;
+    }
+
+    // Clusters facing away from the center are on the outside and tend to
+    // occlude the rest, so they are drawn first
+    for (ClusterInfo& info : infos) {
+        float length = std::sqrt(info.normal[0] * info.normal[0] + info.normal[1] * info.normal[1] + info.normal[2] * info.normal[2]);
+        info.sortKey = 0.0f;
+        if (length > 0.0f) {
+            for (int axis = 0; axis < 3; axis++) {
+                info.sortKey += (info.centroid[axis] - meshCentroid[axis]) * info.normal[axis] / length;
+            }
+        }
+    }
+    std::stable_sort(infos.begin(), infos.end(), [](const ClusterInfo& a, const ClusterInfo& b) {
+        return a.sortKey > b.sortKey;
+    });
+
+    std::vector<uint32_t> output;
+    output.reserve(triangleCount * 3);
+    for (const ClusterInfo& info : infos) {
+        output.insert(output.end(), indices + info.begin * 3, indices + info.end * 3);
+    }
+    std::copy(output.begin(), output.end(), indices);
+}
+
+void optimizeVertexFetch(std::vector<Vertex>& vertices, std::vector<uint32_t>& indices) {
+    std::vector<uint32_t> remap(vertices.size(), UINT32_MAX);
+    std::vector<Vertex> ordered;
+    ordered.reserve(vertices.size());
+
+    for (uint32_t& index : indices) {
+        if (remap[index] == UINT32_MAX) {
+            remap[index] = (uint32_t)ordered.size();
+            ordered.push_back(vertices[index]);
+        }
+        index = remap[index];
+    }
+    vertices.swap(ordered);
+}
+
+void optimizeMesh(MeshData& mesh) {
+    for (const Submesh& submesh : mesh.submeshes) {
+        uint32_t* indices = mesh.indices.data() + submesh.firstIndex;
+        optimizeVertexCache(indices, submesh.indexCount, mesh.vertices.size());
+        optimizeOverdraw(indices, submesh.indexCount, mesh.vertices);
+    }
+    optimizeVertexFetch(mesh.vertices, mesh.indices);
+}
@@ -0,0 +1,319 @@
+#include "../Header/MeshSimplifier.h"
+#include <algorithm>
+#include <numeric>
+#include <cmath>
+
+namespace {
+
+// Sum of squared distances to a set of planes, as the symmetric 4x4 matrix
+// of plane * plane^T; evaluating it at a point gives the error of moving there
+struct Quadric {
+    double a2, ab, ac, ad, b2, bc, bd, c2, cd, d2;
+
+    void addPlane(double a, double b, double c, double d, double weight) {
+        a2 += weight * a * a; ab += weight * a * b; ac += weight * a * c; ad += weight * a * d;
+        b2 += weight * b * b; bc += weight * b * c; bd += weight * b * d;
+        c2 += weight * c * c; cd += weight * c * d;
+        d2 += weight * d * d;
+    }
+
+    void add(const Quadric& q) {
+        a2 += q.a2; ab += q.ab; ac += q.ac; ad += q.ad;
+        b2 += q.b2; bc += q.bc; bd += q.bd;
+        c2 += q.c2; cd += q.cd;
+        d2 += q.d2;
+    }
+
+    double error(const Vertex& p) const {
+        double x = p.x, y = p.y, z = p.z;
+        double e = a2 * x * x + 2.0 * ab * x * y + 2.0 * ac * x * z + 2.0 * ad * x
+                 + b2 * y * y + 2.0 * bc * y * z + 2.0 * bd * y
+                 + c2 * z * z + 2.0 * cd * z
+                 + d2;
+        return e > 0.0 ? e : 0.0;
+    }
+};
+
+// Open mesh borders get a perpendicular plane this much stronger than a face,
+// so silhouettes and material boundaries move last
+const double BORDER_WEIGHT = 10.0;
+
+// A collapse may turn a neighbouring triangle's normal by at most ~75 degrees
+const float MIN_NORMAL_DOT = 0.25f;
+
+struct Vec3 {
+    float x, y, z;
+};
+
+inline Vec3 sub(const Vertex& a, const Vertex& b) {
+    return Vec3{ a.x - b.x, a.y - b.y, a.z - b.z };
+}
+
+inline Vec3 cross(const Vec3& a, const Vec3& b) {
+    return Vec3{ a.y * b.z - a.z * b.y, a.z * b.x - a.x * b.z, a.x * b.y - a.y * b.x };
+}
+
+inline float dot(const Vec3& a, const Vec3& b) {
+    return a.x * b.x + a.y * b.y + a.z * b.z;
+}
+
+inline float length(const Vec3& a) {
+    return std::sqrt(dot(a, a));
+}
+
+struct Collapse {
+    uint32_t from, to;   // Position ids
+    double cost;
+};
+
+} // namespace
+
+float simplifyTriangles(const std::vector<Vertex>& vertices, const uint32_t* indices, size_t indexCount,
+                        size_t targetIndexCount, std::vector<uint32_t>& out) {
+    out.assign(indices, indices + indexCount);
+    if (indexCount <= targetIndexCount) return 0.0f;
+    size_t vertexCount = vertices.size();
+
+    // Weld vertices that share a position (copies split on UV/normal seams)
+    std::vector<uint32_t> order(vertexCount);
+    std::iota(order.begin(), order.end(), 0);
+    auto lessPosition = [&vertices](uint32_t a, uint32_t b) {
+        const Vertex& va = vertices[a];
+        const Vertex& vb = vertices[b];
+        if (va.x != vb.x) return va.x < vb.x;
+        if (va.y != vb.y) return va.y < vb.y;
+        return va.z < vb.z;
+    };
+    std::sort(order.begin(), order.end(), lessPosition);
+
+    std::vector<uint32_t> positionOf(vertexCount);
+    std::vector<uint32_t> positionVertex;    // One vertex per position id, for its coordinates
+    for (size_t i = 0; i < vertexCount; i++) {
+        if (i == 0 || lessPosition(order[i - 1], order[i])) positionVertex.push_back(order[i]);
+        positionOf[order[i]] = (uint32_t)positionVertex.size() - 1;
+    }
+    size_t positionCount = positionVertex.size();
+    auto position = [&](uint32_t id) -> const Vertex& { return vertices[positionVertex[id]]; };
+
+    // Face planes, plus perpendicular planes along edges that only one triangle uses
+    std::vector<Quadric> quadrics(positionCount, Quadric{});
+    std::vector<uint64_t> edges;
+    edges.reserve(indexCount);
+    for (size_t t = 0; t + 2 < indexCount; t += 3) {
+        uint32_t p[3] = { positionOf[out[t]], positionOf[out[t + 1]], positionOf[out[t + 2]] };
+        Vec3 n = cross(sub(position(p[1]), position(p[0])), sub(position(p[2]), position(p[0])));
+        float len = length(n);
+        if (len == 0.0f) continue;
+        n = Vec3{ n.x / len, n.y / len, n.z / len };
+        const Vertex& origin = position(p[0]);
+        double d = -(double)(n.x * origin.x + n.y * origin.y + n.z * origin.z);
+        for (int k = 0; k < 3; k++) {
+            quadrics[p[k]].addPlane(n.x, n.y, n.z, d, 1.0);
+            uint32_t a = p[k], b = p[(k + 1) % 3];
+            edges.push_back(((uint64_t)std::min(a, b) << 32) | std::max(a, b));
+        }
+    }
+    std::sort(edges.begin(), edges.end());
+    for (size_t t = 0; t + 2 < indexCount; t += 3) {
+        uint32_t p[3] = { positionOf[out[t]], positionOf[out[t + 1]], positionOf[out[t + 2]] };
+        Vec3 n = cross(sub(position(p[1]), position(p[0])), sub(position(p[2]), position(p[0])));
+        if (length(n) == 0.0f) continue;
+        for (int k = 0; k < 3; k++) {
+            uint32_t a = p[k], b = p[(k + 1) % 3];
+            uint64_t key = ((uint64_t)std::min(a, b) << 32) | std::max(a, b);
+            auto range = std::equal_range(edges.begin(), edges.end(), key);
+            if (range.second - range.first != 1) continue;
+
+            Vec3 edge = sub(position(b), position(a));
+            Vec3 m = cross(edge, n);
+            float len = length(m);
+            if (len == 0.0f) continue;
+            m = Vec3{ m.x / len, m.y / len, m.z / len };
+            const Vertex& origin = position(a);
+            double d = -(double)(m.x * origin.x + m.y * origin.y + m.z * origin.z);
+            quadrics[a].addPlane(m.x, m.y, m.z, d, BORDER_WEIGHT);
+            quadrics[b].addPlane(m.x, m.y, m.z, d, BORDER_WEIGHT);
+        }
+    }
+
+    double maxError = 0.0;
+    std::vector<uint32_t> remap(vertexCount);
+    std::vector<uint32_t> triangleOffsets(positionCount + 1);
+    std::vector<uint32_t> triangleList;
+    std::vector<Collapse> collapses;
+    std::vector<char> locked(positionCount);
+
+    while (out.size() > targetIndexCount) {
+        size_t triangleCount = out.size() / 3;
+
+        // Triangles around every position
+        std::fill(triangleOffsets.begin(), triangleOffsets.end(), 0);
+        for (uint32_t index : out) triangleOffsets[positionOf[index] + 1]++;
+        for (size_t p = 0; p < positionCount; p++) triangleOffsets[p + 1] += triangleOffsets[p];
+        triangleList.resize(out.size());
+        {
+            std::vector<uint32_t> fill(triangleOffsets.begin(), triangleOffsets.end() - 1);
+            for (size_t i = 0; i < out.size(); i++) triangleList[fill[positionOf[out[i]]]++] = (uint32_t)(i / 3);
+        }
+
+        // Every edge once, collapsed in its cheaper direction
+        collapses.clear();
+        edges.clear();
+        for (size_t i = 0; i < out.size(); i += 3) {
+            for (int k = 0; k < 3; k++) {
+                uint32_t a = positionOf[out[i + k]], b = positionOf[out[i + (k + 1) % 3]];
+                edges.push_back(((uint64_t)std::min(a, b) << 32) | std::max(a, b));
+            }
+        }
+        std::sort(edges.begin(), edges.end());
+        edges.erase(std::unique(edges.begin(), edges.end()), edges.end());
+        for (uint64_t edge : edges) {
+            uint32_t a = (uint32_t)(edge >> 32), b = (uint32_t)edge;
+            Quadric q = quadrics[a];
+            q.add(quadrics[b]);
+            double toB = q.error(position(b)), toA = q.error(position(a));
+            collapses.push_back(toB <= toA ? Collapse{ a, b, toB } : Collapse{ b, a, toA });
+        }
+        std::sort(collapses.begin(), collapses.end(), [](const Collapse& x, const Collapse& y) { return x.cost < y.cost; });
+
+        // Take the cheapest independent collapses; each removes about two triangles.
+        // Only the cheaper part of the list is used per pass to stay close to greedy order.
+        std::fill(locked.begin(), locked.end(), 0);
+        std::iota(remap.begin(), remap.end(), 0);
+        size_t collapseLimit = (triangleCount - targetIndexCount / 3) / 2 + 1;
+        size_t performed = 0;
+
+        for (size_t c = 0; c < collapses.size() && performed < collapseLimit; c++) {
+            if (performed > 0 && c >= collapses.size() / 4) break;
+            const Collapse& collapse = collapses[c];
+            if (locked[collapse.from] || locked[collapse.to]) continue;
+
+            // Reject collapses that flip or squash a remaining neighbour triangle
+            const Vertex& target = position(collapse.to);
+            bool valid = true;
+            for (uint32_t i = triangleOffsets[collapse.from]; i < triangleOffsets[collapse.from + 1] && valid; i++) {
+                const uint32_t* triangle = &out[triangleList[i] * 3];
+                uint32_t p[3] = { positionOf[triangle[0]], positionOf[triangle[1]], positionOf[triangle[2]] };
+                if (p[0] == collapse.to || p[1] == collapse.to || p[2] == collapse.to) continue;
+
+                const Vertex* before[3] = { &position(p[0]), &position(p[1]), &position(p[2]) };
+                const Vertex* after[3] = { before[0], before[1], before[2] };
+                for (int k = 0; k < 3; k++) {
+                    if (p[k] == collapse.from) after[k] = &target;
+                }
+                Vec3 n0 = cross(sub(*before[1], *before[0]), sub(*before[2], *before[0]));
+                Vec3 n1 = cross(sub(*after[1], *after[0]), sub(*after[2], *after[0]));
+                float l0 = length(n0), l1 = length(n1);
+                if (l1 <= l0 * 1e-4f || dot(n0, n1) < MIN_NORMAL_DOT * l0 * l1) valid = false;
+            }
+            if (!valid) continue;
+
+            // Each copy of the removed vertex moves onto the copy of the target it
+            // shares a triangle with, or failing that the one with the closest attributes
+            for (uint32_t i = triangleOffsets[collapse.from]; i < triangleOffsets[collapse.from + 1]; i++) {
+                const uint32_t* triangle = &out[triangleList[i] * 3];
+                for (int k = 0; k < 3; k++) {
+                    if (positionOf[triangle[k]] != collapse.from || remap[triangle[k]] != triangle[k]) continue;
+                    for (int j = 0; j < 3; j++) {
+                        if (positionOf[triangle[j]] == collapse.to) remap[triangle[k]] = triangle[j];
+                    }
+                }
+            }
+            for (uint32_t i = triangleOffsets[collapse.from]; i < triangleOffsets[collapse.from + 1]; i++) {
+                const uint32_t* triangle = &out[triangleList[i] * 3];
+                for (int k = 0; k < 3; k++) {
+                    uint32_t v = triangle[k];
+                    if (positionOf[v] != collapse.from || remap[v] != v) continue;
+
+                    const Vertex& source = vertices[v];
+                    float bestDistance = -1.0f;
+                    for (uint32_t n = triangleOffsets[collapse.to]; n < triangleOffsets[collapse.to + 1]; n++) {
+                        const uint32_t* other = &out[triangleList[n] * 3];
+                        for (int j = 0; j < 3; j++) {
+                            if (positionOf[other[j]] != collapse.to) continue;
+                            const Vertex& w = vertices[other[j]];
+                            float du = w.u - source.u, dv = w.v - source.v;
+                            float dx = w.nx - source.nx, dy = w.ny - source.ny, dz = w.nz - source.nz;
+                            float distance = du * du + dv * dv + dx * dx + dy * dy + dz * dz;
+                            if (bestDistance < 0.0f || distance < bestDistance) {
+                                bestDistance = distance;
+                                remap[v] = other[j];
+                            }
+                        }
+                    }
+                }
+            }
+
+            quadrics[collapse.to].add(quadrics[collapse.from]);
+            maxError = std::max(maxError, collapse.cost);
+            performed++;
+
+            // The one-ring of the removed vertex changed shape this pass
+            for (uint32_t i = triangleOffsets[collapse.from]; i < triangleOffsets[collapse.from + 1]; i++) {
+                const uint32_t* triangle = &out[triangleList[i] * 3];
+                for (int k = 0; k < 3; k++) locked[positionOf[triangle[k]]] = 1;
+            }
+        }
+        if (performed == 0) break;
+
+        // Rewrite the triangles and drop the ones that collapsed
+        size_t write = 0;
+        for (size_t i = 0; i < out.size(); i += 3) {
+            uint32_t a = remap[out[i]], b = remap[out[i + 1]], c = remap[out[i + 2]];
+            uint32_t pa = positionOf[a], pb = positionOf[b], pc = positionOf[c];
+            if (pa == pb || pb == pc || pa == pc) continue;
+            out[write++] = a;
+            out[write++] = b;
+            out[write++] = c;
+        }
+        out.resize(write);
+    }
+
+    return (float)std::sqrt(maxError);
+}
+
+void generateLods(MeshData& mesh) {
+    mesh.lods.clear();
+    mesh.lods.push_back(MeshLod{ 0, (uint32_t)mesh.submeshes.size(), 0.0f });
+    if (mesh.indices.size() / 3 < MIN_LOD_TRIANGLES) return;
+
+    size_t levelSubmeshes = mesh.submeshes.size();
+    size_t previousFirst = 0;
+    size_t previousTriangles = mesh.indices.size() / 3;
+    float previousError = 0.0f;
+
+    for (size_t level = 1; level < MAX_LODS; level++) {
+        size_t firstSubmesh = mesh.submeshes.size();
+        size_t firstIndex = mesh.indices.size();
+        size_t triangles = 0;
+        float levelError = 0.0f;
+
+        for (size_t s = 0; s < levelSubmeshes; s++) {
+            Submesh submesh = mesh.submeshes[previousFirst + s];
+            std::vector<uint32_t> simplified;
+            float error = simplifyTriangles(mesh.vertices, mesh.indices.data() + submesh.firstIndex, submesh.indexCount,
+                                            submesh.indexCount / 6 * 3, simplified);
+
+            submesh.firstIndex = (uint32_t)mesh.indices.size();
+            submesh.indexCount = (uint32_t)simplified.size();
+            submesh.bounds = computeBounds(&mesh.vertices[0].x, sizeof(Vertex), simplified.data(), simplified.size());
+            mesh.indices.insert(mesh.indices.end(), simplified.begin(), simplified.end());
+            mesh.submeshes.push_back(submesh);
+            triangles += simplified.size() / 3;
+            levelError = std::max(levelError, error);
+        }
+
+        // A level that barely shrinks is not worth its index memory
+        if (triangles * 4 > previousTriangles * 3) {
+            mesh.indices.resize(firstIndex);
+            mesh.submeshes.resize(firstSubmesh);
+            break;
+        }
+
+        // Each level is simplified from the previous one, so the errors add up
+        previousError += levelError;
+        mesh.lods.push_back(MeshLod{ (uint32_t)firstSubmesh, (uint32_t)levelSubmeshes, previousError });
+        previousFirst = firstSubmesh;
+        previousTriangles = triangles;
+    }
+}
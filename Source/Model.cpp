@@ -1,198 +1,477 @@
 #include "../Header/Model.h"
+#include "../Header/ObjParser.h"
+#include "../Header/MappedFile.h"
+#include "../Header/CookedMesh.h"
+#include "../Header/VertexPacking.h"
+#include "../Header/MeshOptimizer.h"
+#include "../Header/MeshSimplifier.h"
+#include "../Header/ThreadPool.h"
+#include "../Header/LockFreeQueue.h"
 #include <iostream>
-#include <fstream>
-#include <sstream>
 #include <vector>
-#include <cstring>
+#include <memory>
+#include <algorithm>
+#include <thread>
+#include <chrono>
+#include <cstddef>
+#include <glm/glm.hpp>
+
+// Model data prepared off the GL thread, waiting for buffer creation
+struct PendingMesh {
+    std::string path;
+    ModelHandle handle = INVALID_MODEL;  // Slot to fill (background loads)
+    std::string cookedPath;
+    bool allowPacked = true;
+    bool loaded = false;
+    bool fromCooked = false;
+    bool cookWriteFailed = false;
+    std::string error;
+    double prepareMs = 0.0;
+    VertexCacheStats cacheBefore = {};  // Index order as exported / after optimizeMesh
+    VertexCacheStats cacheAfter = {};
+    CookedMesh cooked;       // Valid when fromCooked
+    MeshData mesh;           // Valid otherwise
+    std::string mtlPath;     // mtllib of the OBJ, relative to the working directory
+    bool mtlMissing = false;
+    std::vector<MaterialDesc> materials;
+};
+
+ModelCache::ModelCache() : materials(textures), vertexPacking(true), floatGeometry(false), packedGeometry(true),
+                           memoryBudget(0), residentBytes(0), frameIndex(0), evictionCount(0),
+                           finished(std::make_shared<PendingMeshQueue>(MODEL_LOAD_QUEUE_CAPACITY)), loadsInFlight(0) {}
 
 ModelCache::~ModelCache() {
     clear();
 }
 
 void ModelCache::clear() {
-    for (auto& pair : models) {
-        Model& model = pair.second;
-        if (model.VBO != 0) {
-            glDeleteBuffers(1, &model.VBO);
+    // Background loads still point at the slots; wait for them and drop the meshes
+    std::unique_ptr<PendingMesh> pending;
+    while (loadsInFlight > 0) {
+        if (finished->pop(pending)) {
+            loadsInFlight--;
+            pending.reset();
         }
-        if (model.VAO != 0) {
-            glDeleteVertexArrays(1, &model.VAO);
+        else {
+            std::this_thread::yield();
         }
     }
+    
+    // Models only reference arena ranges, so dropping the arenas frees everything
+    floatGeometry.destroy();
+    packedGeometry.destroy();
+    placeholder = Model();
+    residentBytes = 0;
+    evictionCount = 0;
     models.clear();
+    handles.clear();
+    materials.clear();
+    textures.purgeUnused();
 }
 
 bool ModelCache::hasModel(const char* filepath) {
-    return models.find(filepath) != models.end();
+    return handles.find(filepath) != handles.end();
 }
 
-Model* ModelCache::getModel(const char* filepath) {
-    auto it = models.find(filepath);
-    if (it != models.end()) {
-        return &(it->second);
+ModelHandle ModelCache::findModel(const char* filepath) {
+    auto it = handles.find(filepath);
+    if (it != handles.end()) {
+        return it->second;
     }
-    return nullptr;
+    return INVALID_MODEL;
+}
+
+void ModelCache::storeModel(ModelHandle handle, const Model& model) {
+    Model& slot = models[handle - 1];
+    std::string path = slot.path;
+    slot = model;
+    slot.path = path;
+    slot.status = MODEL_READY;
+    slot.lastUsedFrame = frameIndex;
+    residentBytes += cpuBytes(slot) + gpuBytes(slot);
+}
+
+uint64_t ModelCache::cpuBytes(const Model& model) {
+    return model.submeshes.capacity() * sizeof(Submesh) + model.lods.capacity() * sizeof(MeshLod);
+}
+
+uint64_t ModelCache::gpuBytes(const Model& model) {
+    return model.geometry.vertexBytes + model.geometry.indexBytes;
+}
+
+void ModelCache::evictModel(ModelHandle handle) {
+    Model* model = getModel(handle);
+    if (!model || model->status != MODEL_READY) return;
+    
+    residentBytes -= cpuBytes(*model) + gpuBytes(*model);
+    getGeometry(model->packed).release(model->geometry);
+    
+    // Bounds stay valid for culling and collision while the model is away
+    Model evicted;
+    evicted.status = MODEL_EVICTED;
+    evicted.path = model->path;
+    evicted.bounds = model->bounds;
+    evicted.lastUsedFrame = model->lastUsedFrame;
+    *model = evicted;
+    evictionCount++;
 }
 
-// Parse OBJ file and create OpenGL buffers
-unsigned int ModelCache::loadModel(const char* filepath) {
-    // Check if already loaded
-    if (hasModel(filepath)) {
-        Model* existing = getModel(filepath);
-        if (existing) {
-            return existing->VAO;
+// Evict least recently drawn models until the resident ones fit the budget.
+// Models drawn this frame are never evicted, so a budget smaller than one
+// frame's working set only overshoots instead of reloading every frame.
+void ModelCache::endFrame() {
+    if (memoryBudget != 0 && residentBytes > memoryBudget) {
+        std::vector<ModelHandle> candidates;
+        for (size_t i = 0; i < models.size(); i++) {
+            if (models[i].status == MODEL_READY && models[i].lastUsedFrame < frameIndex) {
+                candidates.push_back((ModelHandle)(i + 1));
+            }
+        }
+        std::sort(candidates.begin(), candidates.end(), [this](ModelHandle a, ModelHandle b) {
+            return models[a - 1].lastUsedFrame < models[b - 1].lastUsedFrame;
+        });
+        
+        uint64_t before = residentBytes;
+        size_t evicted = 0;
+        for (ModelHandle handle : candidates) {
+            if (residentBytes <= memoryBudget) break;
+            evictModel(handle);
+            evicted++;
+        }
+        if (evicted > 0) {
+            std::cout << "Evicted " << evicted << " models (" << (before - residentBytes) / 1024 << " KB) to stay within the "
+                      << memoryBudget / 1024 << " KB model budget" << std::endl;
         }
     }
+    frameIndex++;
+}
+
+ModelCacheStats ModelCache::getStats() const {
+    ModelCacheStats stats = {};
+    stats.models = models.size();
+    for (const Model& model : models) {
+        if (model.status == MODEL_READY) {
+            stats.residentModels++;
+            stats.cpuBytes += cpuBytes(model);
+            stats.gpuBytes += gpuBytes(model);
+            if (model.packed) stats.packedBytesSaved += (uint64_t)model.vertexCount * (sizeof(Vertex) - sizeof(PackedVertex));
+        }
+        else if (model.status == MODEL_LOADING) {
+            stats.loadingModels++;
+        }
+        else if (model.status == MODEL_EVICTED) {
+            stats.evictedModels++;
+        }
+    }
+    stats.evictions = evictionCount;
+    stats.gpuCapacityBytes = floatGeometry.capacityBytes() + packedGeometry.capacityBytes();
+    stats.budgetBytes = memoryBudget;
+    return stats;
+}
+
+// Copy a mesh whose data is already in GPU layout into the arena of its vertex
+// layout (PackedVertex if packed, Vertex otherwise)
+Model ModelCache::createModelBuffers(const void* vertexData, uint32_t vertexCount, bool packed,
+                                     const void* indexData, uint32_t indexCount, uint32_t indexSize) {
+    Model model;
+    model.packed = packed;
+    model.vertexCount = vertexCount;
+    model.indexCount = indexCount;
+    model.indexType = (indexSize == 2) ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT;
     
-    std::cout << "Loading OBJ model: " << filepath << std::endl;
+    GeometryArena& arena = getGeometry(packed);
+    model.geometry = arena.allocate(vertexData, vertexCount, indexData, (uint64_t)indexCount * indexSize);
+    model.VAO = arena.getVAO();
     
-    // Temporary storage for OBJ data
-    std::vector<float> temp_positions;
-    std::vector<float> temp_texcoords;
-    std::vector<float> temp_normals;
+    return model;
+}
+
+// Parse the OBJ's material library, if it names one
+static void prepareMaterials(PendingMesh& pending) {
+    const char* library = pending.fromCooked ? pending.cooked.info().materialLibrary : pending.mesh.materialLibrary.c_str();
+    if (library[0] == '\0') return;
     
-    // Final interleaved vertex data
-    std::vector<Vertex> vertices;
+    size_t slash = pending.path.find_last_of("/\\");
+    pending.mtlPath = (slash == std::string::npos ? std::string() : pending.path.substr(0, slash + 1)) + library;
     
-    std::ifstream file(filepath);
-    if (!file.is_open()) {
-        std::cout << "ERROR: Could not open OBJ file: " << filepath << std::endl;
-        return 0;
+    MappedFile file;
+    if (!file.open(pending.mtlPath.c_str())) {
+        pending.mtlMissing = true;
+        return;
     }
+    parseMTL(file.data(), file.size(), pending.materials);
+}
+
+// Read the cooked mesh if it is up to date, otherwise parse the OBJ file and
+// write a fresh cooked mesh next to it. Touches only files, never OpenGL,
+// so it is safe to run on worker threads.
+static void prepareMesh(PendingMesh& pending) {
+    auto startTime = std::chrono::steady_clock::now();
     
-    std::string line;
-    while (std::getline(file, line)) {
-        std::istringstream iss(line);
-        std::string prefix;
-        iss >> prefix;
+    MappedFile file;
+    if (!file.open(pending.path.c_str())) {
+        pending.error = "Could not open OBJ file: " + pending.path;
+        return;
+    }
+    uint64_t sourceHash = hashBytes(file.data(), file.size());
+    pending.cookedPath = cookedMeshPath(pending.path.c_str());
+    
+    if (pending.cooked.open(pending.cookedPath.c_str(), sourceHash, file.size(), pending.allowPacked)) {
+        pending.fromCooked = true;
+    }
+    else {
+        if (!parseOBJ(file.data(), file.size(), pending.mesh, &ThreadPool::shared())) {
+            pending.error = "No vertices loaded from OBJ file: " + pending.path;
+            return;
+        }
         
-        if (prefix == "v") {
-            // Vertex position
-            float x, y, z;
-            iss >> x >> y >> z;
-            temp_positions.push_back(x);
-            temp_positions.push_back(y);
-            temp_positions.push_back(z);
-        }
-        else if (prefix == "vt") {
-            // Texture coordinate
-            float u, v;
-            iss >> u >> v;
-            temp_texcoords.push_back(u);
-            temp_texcoords.push_back(v);
-        }
-        else if (prefix == "vn") {
-            // Normal
-            float nx, ny, nz;
-            iss >> nx >> ny >> nz;
-            temp_normals.push_back(nx);
-            temp_normals.push_back(ny);
-            temp_normals.push_back(nz);
-        }
-        else if (prefix == "f") {
-            // Face (assuming triangles)
-            // Format: f v1/vt1/vn1 v2/vt2/vn2 v3/vt3/vn3
-            std::string vertex1, vertex2, vertex3;
-            iss >> vertex1 >> vertex2 >> vertex3;
-            
-            std::string vertexData[3] = {vertex1, vertex2, vertex3};
-            
-            for (int i = 0; i < 3; i++) {
-                Vertex vert;
-                int posIdx = 0, texIdx = 0, normIdx = 0;
-                
-                // Parse vertex data (format: pos/tex/norm or pos//norm or pos/tex or pos)
-                size_t slash1 = vertexData[i].find('/');
-                if (slash1 != std::string::npos) {
-                    posIdx = std::stoi(vertexData[i].substr(0, slash1));
-                    
-                    size_t slash2 = vertexData[i].find('/', slash1 + 1);
-                    if (slash2 != std::string::npos) {
-                        if (slash2 > slash1 + 1) {
-                            texIdx = std::stoi(vertexData[i].substr(slash1 + 1, slash2 - slash1 - 1));
-                        }
-                        normIdx = std::stoi(vertexData[i].substr(slash2 + 1));
-                    }
-                    else {
-                        // Only position and texture
-                        texIdx = std::stoi(vertexData[i].substr(slash1 + 1));
-                    }
-                }
-                else {
-                    // Only position
-                    posIdx = std::stoi(vertexData[i]);
-                }
-                
-                // OBJ indices are 1-based, convert to 0-based
-                posIdx--; texIdx--; normIdx--;
-                
-                // Set position
-                if (posIdx >= 0 && posIdx * 3 + 2 < (int)temp_positions.size()) {
-                    vert.x = temp_positions[posIdx * 3 + 0];
-                    vert.y = temp_positions[posIdx * 3 + 1];
-                    vert.z = temp_positions[posIdx * 3 + 2];
-                } else {
-                    vert.x = vert.y = vert.z = 0.0f;
-                }
-                
-                // Set texture coordinates
-                if (texIdx >= 0 && texIdx * 2 + 1 < (int)temp_texcoords.size()) {
-                    vert.u = temp_texcoords[texIdx * 2 + 0];
-                    vert.v = temp_texcoords[texIdx * 2 + 1];
-                } else {
-                    vert.u = vert.v = 0.0f;
-                }
-                
-                // Set normals
-                if (normIdx >= 0 && normIdx * 3 + 2 < (int)temp_normals.size()) {
-                    vert.nx = temp_normals[normIdx * 3 + 0];
-                    vert.ny = temp_normals[normIdx * 3 + 1];
-                    vert.nz = temp_normals[normIdx * 3 + 2];
-                } else {
-                    vert.nx = 0.0f; vert.ny = 1.0f; vert.nz = 0.0f; // Default up
-                }
-                
-                vertices.push_back(vert);
-            }
+        // Build the LOD chain, then reorder every level for the vertex cache,
+        // overdraw and fetch locality; the cooked mesh stores the result, so
+        // this only runs when the OBJ changed
+        // (statistics are for the full-detail level, which stays at the front)
+        MeshData& mesh = pending.mesh;
+        size_t fullDetailIndices = mesh.indices.size();
+        pending.cacheBefore = analyzeVertexCache(mesh.indices.data(), fullDetailIndices, mesh.vertices.size());
+        generateLods(mesh);
+        optimizeMesh(mesh);
+        pending.cacheAfter = analyzeVertexCache(mesh.indices.data(), fullDetailIndices, mesh.vertices.size());
+        
+        if (pending.allowPacked && canPackVertices(pending.mesh)) {
+            packVertices(pending.mesh);
         }
+        pending.cookWriteFailed = !writeCookedMesh(pending.cookedPath.c_str(), sourceHash, file.size(), pending.mesh);
     }
+    prepareMaterials(pending);
     
-    file.close();
+    pending.loaded = true;
+    pending.prepareMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startTime).count();
+}
+
+// Create OpenGL buffers for a prepared mesh and register its materials (GL thread only)
+Model ModelCache::uploadMesh(PendingMesh& pending) {
+    MaterialLibrary& library = materials;
+    Model model;
+    if (pending.fromCooked) {
+        // Cooked data is already in GPU layout - upload straight from the mapping
+        const CookedMeshHeader& info = pending.cooked.info();
+        model = createModelBuffers(pending.cooked.vertexData(), info.vertexCount, info.vertexFormat == VERTEX_FORMAT_PACKED,
+                                   pending.cooked.indexData(), info.indexCount, info.indexSize);
+        model.submeshes.assign(pending.cooked.submeshes(), pending.cooked.submeshes() + info.submeshCount);
+        model.lods.assign(pending.cooked.lods(), pending.cooked.lods() + info.lodCount);
+        model.bounds = info.bounds;
+        model.positionScale = info.positionScale;
+        std::copy(info.positionOffset, info.positionOffset + 3, model.positionOffset);
+    }
+    else {
+        const MeshData& mesh = pending.mesh;
+        bool packed = !mesh.packedVertices.empty();
+        const void* vertexData = packed ? (const void*)mesh.packedVertices.data() : (const void*)mesh.vertices.data();
+        
+        // Use 16-bit indices when they fit
+        if (mesh.vertices.size() <= 0xFFFF) {
+            std::vector<uint16_t> shortIndices(mesh.indices.begin(), mesh.indices.end());
+            model = createModelBuffers(vertexData, (uint32_t)mesh.vertices.size(), packed,
+                                       shortIndices.data(), (uint32_t)shortIndices.size(), sizeof(uint16_t));
+        }
+        else {
+            model = createModelBuffers(vertexData, (uint32_t)mesh.vertices.size(), packed,
+                                       mesh.indices.data(), (uint32_t)mesh.indices.size(), sizeof(uint32_t));
+        }
+        model.submeshes = mesh.submeshes;
+        model.lods = mesh.lods;
+        model.bounds = mesh.bounds;
+        model.positionScale = mesh.positionScale;
+        std::copy(mesh.positionOffset, mesh.positionOffset + 3, model.positionOffset);
+    }
     
-    if (vertices.empty()) {
-        std::cout << "ERROR: No vertices loaded from OBJ file: " << filepath << std::endl;
-        return 0;
+    if (model.lods.empty()) {
+        model.lods.push_back(MeshLod{ 0, (uint32_t)model.submeshes.size(), 0.0f });
     }
     
-    std::cout << "Loaded " << vertices.size() << " vertices from " << filepath << std::endl;
+    // Point every submesh at its material's slot; unknown names use the default
+    for (const MaterialDesc& desc : pending.materials) {
+        library.addMaterial(pending.mtlPath, desc);
+    }
+    for (Submesh& submesh : model.submeshes) {
+        submesh.materialIndex = library.find(pending.mtlPath, submesh.material);
+    }
+    if (pending.mtlMissing) {
+        std::cout << "WARNING: Could not open material library: " << pending.mtlPath << std::endl;
+    }
     
-    // Create OpenGL buffers
-    Model model;
-    model.vertexCount = vertices.size();
+    if (pending.cookWriteFailed) {
+        std::cout << "WARNING: Could not write cooked mesh: " << pending.cookedPath << std::endl;
+    }
+    std::cout << "Loaded " << model.vertexCount << " vertices (" << model.indexCount << " indices) from "
+              << (pending.fromCooked ? pending.cookedPath : pending.path) << " in " << pending.prepareMs << " ms";
+    if (model.packed) {
+        std::cout << ", packed vertices save " << model.vertexCount * (sizeof(Vertex) - sizeof(PackedVertex)) / 1024 << " KB";
+    }
+    std::cout << std::endl;
+    if (model.lods.size() > 1) {
+        std::cout << "  LOD triangles:";
+        for (const MeshLod& lod : model.lods) {
+            uint32_t indices = 0;
+            for (uint32_t s = 0; s < lod.submeshCount; s++) indices += model.submeshes[lod.firstSubmesh + s].indexCount;
+            std::cout << " " << indices / 3;
+        }
+        std::cout << " (max error " << model.lods.back().error << ")" << std::endl;
+    }
+    if (!pending.fromCooked) {
+        std::cout << "  Vertex cache (FIFO " << VERTEX_CACHE_SIZE << "): ACMR " << pending.cacheBefore.acmr << " -> " << pending.cacheAfter.acmr
+                  << ", ATVR " << pending.cacheBefore.atvr << " -> " << pending.cacheAfter.atvr << std::endl;
+    }
+    return model;
+}
+
+// Load a model from file (or return cached version)
+ModelHandle ModelCache::loadModel(const char* filepath) {
+    ModelHandle handle = reserveModel(filepath);
+    
+    // Already loading in the background: finish that load instead of starting another
+    while (models[handle - 1].status == MODEL_LOADING) {
+        if (pumpUploads(0.0) == 0) std::this_thread::yield();
+    }
+    
+    ModelStatus status = models[handle - 1].status;
+    if (status == MODEL_UNLOADED || status == MODEL_EVICTED) {
+        std::cout << "Loading OBJ model: " << filepath << std::endl;
+        
+        PendingMesh pending;
+        pending.path = filepath;
+        pending.allowPacked = vertexPacking;
+        prepareMesh(pending);
+        if (!pending.loaded) {
+            std::cout << "ERROR: " << pending.error << std::endl;
+            models[handle - 1].status = MODEL_FAILED;
+        }
+        else {
+            storeModel(handle, uploadMesh(pending));
+        }
+    }
     
-    glGenVertexArrays(1, &model.VAO);
-    glGenBuffers(1, &model.VBO);
+    return models[handle - 1].status == MODEL_READY ? handle : INVALID_MODEL;
+}
+
+ModelHandle ModelCache::reserveModel(const char* filepath) {
+    ModelHandle existing = findModel(filepath);
+    if (existing != INVALID_MODEL) {
+        return existing;
+    }
     
-    glBindVertexArray(model.VAO);
-    glBindBuffer(GL_ARRAY_BUFFER, model.VBO);
-    glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(Vertex), vertices.data(), GL_STATIC_DRAW);
+    Model model;
+    model.status = MODEL_UNLOADED;
+    model.path = filepath;
+    models.push_back(model);
+    ModelHandle handle = (ModelHandle)models.size();
+    handles[filepath] = handle;
+    return handle;
+}
+
+void ModelCache::requestModel(ModelHandle handle) {
+    Model* model = getModel(handle);
+    if (!model || (model->status != MODEL_UNLOADED && model->status != MODEL_EVICTED)) return;
+    model->status = MODEL_LOADING;
+    loadsInFlight++;
     
-    // Position attribute (location 0)
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)0);
-    glEnableVertexAttribArray(0);
+    std::string path = model->path;
+    bool allowPacked = vertexPacking;
+    std::shared_ptr<PendingMeshQueue> queue = finished;
+    ThreadPool::shared().submit([path, allowPacked, handle, queue]() {
+        std::unique_ptr<PendingMesh> pending(new PendingMesh());
+        pending->path = path;
+        pending->handle = handle;
+        pending->allowPacked = allowPacked;
+        prepareMesh(*pending);
+        // Full only while the GL thread is behind on uploads
+        while (!queue->push(pending)) {
+            std::this_thread::yield();
+        }
+    });
+}
+
+// Finished meshes come back through a lock-free queue and only buffer creation
+// runs on this (GL) thread, interleaved with the workers still parsing.
+size_t ModelCache::pumpUploads(double budgetMs) {
+    auto startTime = std::chrono::steady_clock::now();
+    size_t uploaded = 0;
+    std::unique_ptr<PendingMesh> pending;
+    while (loadsInFlight > 0 && finished->pop(pending)) {
+        loadsInFlight--;
+        Model& model = models[pending->handle - 1];
+        if (!pending->loaded) {
+            std::cout << "ERROR: " << pending->error << std::endl;
+            model.status = MODEL_FAILED;
+        }
+        else {
+            storeModel(pending->handle, uploadMesh(*pending));
+            uploaded++;
+        }
+        pending.reset();
+        
+        double elapsedMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startTime).count();
+        if (elapsedMs >= budgetMs) break;
+    }
+    return uploaded;
+}
+
+// Parse a batch of models on the shared worker pool and wait for all of them
+void ModelCache::loadModels(const std::vector<std::string>& filepaths) {
+    std::vector<ModelHandle> requested;
+    for (const std::string& path : filepaths) {
+        ModelHandle handle = reserveModel(path.c_str());
+        ModelStatus status = models[handle - 1].status;
+        if (status == MODEL_UNLOADED || status == MODEL_EVICTED) {
+            requestModel(handle);
+            requested.push_back(handle);
+        }
+    }
+    if (requested.empty()) return;
     
-    // Texture coordinate attribute (location 1)
-    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)(3 * sizeof(float)));
-    glEnableVertexAttribArray(1);
+    std::cout << "Loading " << requested.size() << " OBJ models on " << ThreadPool::shared().size() << " worker threads" << std::endl;
+    auto startTime = std::chrono::steady_clock::now();
     
-    // Normal attribute (location 2)
-    glVertexAttribPointer(2, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)(5 * sizeof(float)));
-    glEnableVertexAttribArray(2);
+    for (ModelHandle handle : requested) {
+        while (models[handle - 1].status == MODEL_LOADING) {
+            if (pumpUploads(0.0) == 0) std::this_thread::yield();
+        }
+    }
     
-    glBindVertexArray(0);
+    double totalMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startTime).count();
+    std::cout << "Loaded model batch in " << totalMs << " ms (packed vertices save "
+              << getStats().packedBytesSaved / 1024 << " KB of VBO memory across resident models)" << std::endl;
+}
+
+const Model& ModelCache::getPlaceholder() {
+    if (placeholder.VAO != 0) return placeholder;
     
-    // Store in cache
-    models[filepath] = model;
+    // Unit cube with per-face normals, centered on the origin
+    static const float faces[6][3] = { { 1, 0, 0 }, { -1, 0, 0 }, { 0, 1, 0 }, { 0, -1, 0 }, { 0, 0, 1 }, { 0, 0, -1 } };
+    Vertex vertices[24];
+    uint16_t indices[36];
+    for (int face = 0; face < 6; face++) {
+        glm::vec3 normal(faces[face][0], faces[face][1], faces[face][2]);
+        glm::vec3 tangent = (face == 2 || face == 3) ? glm::vec3(1, 0, 0) : glm::vec3(0, 1, 0);
+        glm::vec3 bitangent = glm::cross(normal, tangent);
+        for (int corner = 0; corner < 4; corner++) {
+            float s = (corner & 1) ? 1.0f : 0.0f;
+            float t = (corner & 2) ? 1.0f : 0.0f;
+            glm::vec3 p = 0.5f * normal + (s - 0.5f) * tangent + (t - 0.5f) * bitangent;
+            vertices[face * 4 + corner] = Vertex{ p.x, p.y, p.z, s, t, normal.x, normal.y, normal.z };
+        }
+        // tangent x bitangent = normal, so these corners wind counter-clockwise from outside
+        uint16_t base = (uint16_t)(face * 4);
+        uint16_t quad[6] = { 0, 1, 3, 0, 3, 2 };
+        for (int i = 0; i < 6; i++) indices[face * 6 + i] = base + quad[i];
+    }
     
-    return model.VAO;
+    placeholder = createModelBuffers(vertices, 24, false, indices, 36, sizeof(uint16_t));
+    placeholder.path = "<placeholder>";
+    placeholder.bounds = computeBounds(&vertices[0].x, 24, sizeof(Vertex));
+    Submesh submesh = {};
+    submesh.indexCount = 36;
+    submesh.bounds = placeholder.bounds;
+    placeholder.submeshes.push_back(submesh);
+    placeholder.lods.push_back(MeshLod{ 0, 1, 0.0f });
+    return placeholder;
 }
@@ -0,0 +1,714 @@
+#include "../Header/ObjParser.h"
+#include "../Header/MappedFile.h"
+#include "../Header/ThreadPool.h"
+#include <charconv>
+#include <algorithm>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <chrono>
+#include <cstring>
+#include <cmath>
+#include <cstdint>
+#include <string>
+#include <fstream>
+#include <sstream>
+
+// Pointer-scanning OBJ parser.
+// The input is walked once to count elements so every array is allocated a
+// single time, then walked again to fill them. Numbers are parsed in place
+// with std::from_chars, so no per-line strings or streams are created.
+// Large files are split into line-aligned chunks whose count and parse passes
+// run on the worker pool; prefix sums of the per-chunk counts place each
+// chunk's v/vt/vn data directly in the merged arrays.
+// Polygons of any size are triangulated and face corners are deduplicated on
+// their v/vt/vn index triplet, so shared vertices are stored once and
+// referenced from the index buffer. Each usemtl material becomes one submesh.
+
+namespace {
+
+inline bool isSpace(char c) {
+    return c == ' ' || c == '\t' || c == '\r';
+}
+
+inline const char* skipSpaces(const char* p, const char* end) {
+    while (p < end && isSpace(*p)) p++;
+    return p;
+}
+
+inline const char* skipToNextLine(const char* p, const char* end) {
+    while (p < end && *p != '\n') p++;
+    return p < end ? p + 1 : end;
+}
+
+inline const char* parseFloat(const char* p, const char* end, float& value) {
+    p = skipSpaces(p, end);
+    auto result = std::from_chars(p, end, value);
+    if (result.ec != std::errc()) {
+        value = 0.0f;
+        return p;
+    }
+    return result.ptr;
+}
+
+inline const char* parseInt(const char* p, const char* end, int& value) {
+    auto result = std::from_chars(p, end, value);
+    if (result.ec != std::errc()) {
+        value = 0;
+        return p;
+    }
+    return result.ptr;
+}
+
+// Resolve a 1-based (or negative, relative) OBJ index to a 0-based one, -1 if absent
+inline int resolveIndex(int idx, size_t count) {
+    if (idx > 0) return idx - 1;
+    if (idx < 0) return (int)count + idx;
+    return -1;
+}
+
+// Open-addressing map from a v/vt/vn index triplet to the output vertex index.
+// Sized once from the corner count, so inserts never allocate.
+class CornerMap {
+private:
+    struct Slot {
+        int pos, tex, norm;
+        uint32_t vertex;
+    };
+    std::vector<Slot> slots;
+    size_t mask;
+
+    static size_t hash(int pos, int tex, int norm) {
+        uint64_t h = (uint32_t)pos * 0x9E3779B97F4A7C15ull;
+        h ^= (uint32_t)tex * 0xC2B2AE3D27D4EB4Full + (h << 6) + (h >> 2);
+        h ^= (uint32_t)norm * 0x165667B19E3779F9ull + (h << 6) + (h >> 2);
+        return (size_t)(h ^ (h >> 29));
+    }
+
+public:
+    explicit CornerMap(size_t maxCorners) {
+        size_t capacity = 16;
+        while (capacity < maxCorners * 2) capacity <<= 1;
+        slots.assign(capacity, Slot{ 0, 0, 0, UINT32_MAX });
+        mask = capacity - 1;
+    }
+
+    // Returns the vertex index stored for the triplet, or inserts newVertex
+    // and sets inserted = true
+    uint32_t findOrInsert(int pos, int tex, int norm, uint32_t newVertex, bool& inserted) {
+        size_t i = hash(pos, tex, norm) & mask;
+        while (true) {
+            Slot& slot = slots[i];
+            if (slot.vertex == UINT32_MAX) {
+                slot = Slot{ pos, tex, norm, newVertex };
+                inserted = true;
+                return newVertex;
+            }
+            if (slot.pos == pos && slot.tex == tex && slot.norm == norm) {
+                inserted = false;
+                return slot.vertex;
+            }
+            i = (i + 1) & mask;
+        }
+    }
+};
+
+enum LineType { LINE_OTHER, LINE_POSITION, LINE_TEXCOORD, LINE_NORMAL, LINE_FACE, LINE_USEMTL, LINE_MTLLIB };
+
+// Classify the line starting at p and advance p past the keyword
+inline LineType classifyLine(const char*& p, const char* end) {
+    p = skipSpaces(p, end);
+    if (p >= end) return LINE_OTHER;
+
+    if (p[0] == 'v') {
+        if (p + 1 < end && isSpace(p[1])) { p += 1; return LINE_POSITION; }
+        if (p + 2 < end && p[1] == 't' && isSpace(p[2])) { p += 2; return LINE_TEXCOORD; }
+        if (p + 2 < end && p[1] == 'n' && isSpace(p[2])) { p += 2; return LINE_NORMAL; }
+    }
+    else if (p[0] == 'f' && p + 1 < end && isSpace(p[1])) {
+        p += 1;
+        return LINE_FACE;
+    }
+    else if (p[0] == 'u' && end - p > 7 && std::memcmp(p, "usemtl", 6) == 0 && isSpace(p[6])) {
+        p += 6;
+        return LINE_USEMTL;
+    }
+    else if (p[0] == 'm' && end - p > 7 && std::memcmp(p, "mtllib", 6) == 0 && isSpace(p[6])) {
+        p += 6;
+        return LINE_MTLLIB;
+    }
+    return LINE_OTHER;
+}
+
+// Read the rest of the line as a name (trailing whitespace removed)
+inline std::string parseName(const char* p, const char* end) {
+    p = skipSpaces(p, end);
+    const char* nameEnd = p;
+    while (nameEnd < end && *nameEnd != '\n') nameEnd++;
+    while (nameEnd > p && isSpace(nameEnd[-1])) nameEnd--;
+    return std::string(p, nameEnd);
+}
+
+// Count the corners on a face line (p points just past the "f" keyword)
+inline size_t countFaceCorners(const char* p, const char* end) {
+    size_t corners = 0;
+    while (true) {
+        p = skipSpaces(p, end);
+        if (p >= end || *p == '\n' || *p == '#') return corners;
+        corners++;
+        while (p < end && !isSpace(*p) && *p != '\n') p++;
+    }
+}
+
+// Parse one v/vt/vn corner reference into raw (unresolved) OBJ indices
+inline const char* parseCorner(const char* p, const char* end, int& posIdx, int& texIdx, int& normIdx) {
+    posIdx = texIdx = normIdx = 0;
+    p = parseInt(p, end, posIdx);
+    if (p < end && *p == '/') {
+        p++;
+        if (p < end && *p != '/') p = parseInt(p, end, texIdx);
+        if (p < end && *p == '/') {
+            p++;
+            p = parseInt(p, end, normIdx);
+        }
+    }
+    // Skip anything unparsable so the next corner starts on a boundary
+    while (p < end && !isSpace(*p) && *p != '\n') p++;
+    return p;
+}
+
+// "usemtl" switch that takes effect from the given polygon on
+struct MaterialSwitch {
+    size_t polygon;
+    std::string name;
+};
+
+// Line-aligned slice of the file. Counts are filled by countChunk, bases are
+// the prefix sums of the counts of all earlier chunks.
+struct Chunk {
+    const char* begin;
+    const char* end;
+    size_t positions, texcoords, normals, polygons, corners, triangles;
+    size_t positionBase, texcoordBase, normalBase, polygonBase, cornerBase;
+    std::vector<MaterialSwitch> materialSwitches;
+    std::string materialLibrary;            // First mtllib in the chunk, if any
+};
+
+// Global arrays shared by all chunks; each chunk writes only its own range
+struct ParseArrays {
+    std::vector<float> temp_positions;
+    std::vector<float> temp_texcoords;
+    std::vector<float> temp_normals;
+    std::vector<int> temp_corners;          // Resolved v/vt/vn triplets of every polygon corner
+    std::vector<uint32_t> temp_polygonSizes; // Corner count of every polygon
+};
+
+// Pass 1: count elements in a chunk so the arrays are sized once
+void countChunk(Chunk& chunk) {
+    chunk.positions = chunk.texcoords = chunk.normals = 0;
+    chunk.polygons = chunk.corners = chunk.triangles = 0;
+    for (const char* p = chunk.begin; p < chunk.end; ) {
+        const char* line = p;
+        switch (classifyLine(line, chunk.end)) {
+            case LINE_POSITION: chunk.positions++; break;
+            case LINE_TEXCOORD: chunk.texcoords++; break;
+            case LINE_NORMAL:   chunk.normals++;   break;
+            case LINE_FACE: {
+                // Polygons with n corners become n - 2 triangles
+                size_t n = countFaceCorners(line, chunk.end);
+                if (n >= 3) {
+                    chunk.polygons++;
+                    chunk.corners += n;
+                    chunk.triangles += n - 2;
+                }
+                break;
+            }
+            default: break;
+        }
+        p = skipToNextLine(line, chunk.end);
+    }
+}
+
+// Pass 2: parse a chunk's elements into its ranges of the global arrays.
+// Face references are resolved against the global element counts, which the
+// chunk knows from its bases, so relative (negative) indices work across chunks.
+void parseChunk(Chunk& chunk, ParseArrays& arrays) {
+    size_t positions = chunk.positionBase, texcoords = chunk.texcoordBase, normals = chunk.normalBase;
+    size_t polygon = chunk.polygonBase;
+    int* corner = arrays.temp_corners.data() + chunk.cornerBase * 3;
+    chunk.materialSwitches.clear();
+
+    for (const char* p = chunk.begin; p < chunk.end; ) {
+        LineType type = classifyLine(p, chunk.end);
+
+        if (type == LINE_POSITION) {
+            float* dst = &arrays.temp_positions[positions * 3];
+            p = parseFloat(p, chunk.end, dst[0]);
+            p = parseFloat(p, chunk.end, dst[1]);
+            p = parseFloat(p, chunk.end, dst[2]);
+            positions++;
+        }
+        else if (type == LINE_TEXCOORD) {
+            float* dst = &arrays.temp_texcoords[texcoords * 2];
+            p = parseFloat(p, chunk.end, dst[0]);
+            p = parseFloat(p, chunk.end, dst[1]);
+            texcoords++;
+        }
+        else if (type == LINE_NORMAL) {
+            float* dst = &arrays.temp_normals[normals * 3];
+            p = parseFloat(p, chunk.end, dst[0]);
+            p = parseFloat(p, chunk.end, dst[1]);
+            p = parseFloat(p, chunk.end, dst[2]);
+            normals++;
+        }
+        else if (type == LINE_USEMTL) {
+            chunk.materialSwitches.push_back(MaterialSwitch{ polygon, parseName(p, chunk.end) });
+        }
+        else if (type == LINE_MTLLIB) {
+            if (chunk.materialLibrary.empty()) chunk.materialLibrary = parseName(p, chunk.end);
+        }
+        else if (type == LINE_FACE) {
+            // Polygon with any number of corners; triangulated when the mesh is assembled
+            // Corner formats: pos/tex/norm, pos//norm, pos/tex or pos
+            size_t n = countFaceCorners(p, chunk.end);
+            if (n < 3) {
+                p = skipToNextLine(p, chunk.end);
+                continue;
+            }
+            arrays.temp_polygonSizes[polygon++] = (uint32_t)n;
+            for (size_t i = 0; i < n; i++) {
+                int posIdx, texIdx, normIdx;
+                p = skipSpaces(p, chunk.end);
+                p = parseCorner(p, chunk.end, posIdx, texIdx, normIdx);
+                corner[0] = resolveIndex(posIdx, positions);
+                corner[1] = resolveIndex(texIdx, texcoords);
+                corner[2] = resolveIndex(normIdx, normals);
+                corner += 3;
+            }
+        }
+
+        p = skipToNextLine(p, chunk.end);
+    }
+}
+
+// Split the data into up to chunkCount pieces that start and end on line breaks
+std::vector<Chunk> splitIntoChunks(const char* data, size_t size, size_t chunkCount) {
+    std::vector<Chunk> chunks;
+    const char* end = data + size;
+    const char* begin = data;
+    for (size_t i = 1; i <= chunkCount && begin < end; i++) {
+        const char* split = (i == chunkCount) ? end : data + size * i / chunkCount;
+        if (split < begin) split = begin;
+        while (split < end && split[-1] != '\n') split++;
+
+        Chunk chunk = {};
+        chunk.begin = begin;
+        chunk.end = split;
+        chunks.push_back(chunk);
+        begin = split;
+    }
+    return chunks;
+}
+
+// Triangulate one polygon into triangles of local corner numbers (0..n-1).
+// Triangles and quads use a fan. Larger polygons are ear-clipped in the plane
+// of their Newell normal, which also handles the concave caps Blender exports;
+// if clipping gets stuck on degenerate input the rest is fanned.
+void triangulatePolygon(const int* corners, size_t n, const std::vector<float>& positions,
+                        std::vector<uint32_t>& triangles) {
+    triangles.clear();
+    if (n <= 4) {
+        for (size_t i = 1; i + 1 < n; i++) {
+            triangles.push_back(0);
+            triangles.push_back((uint32_t)i);
+            triangles.push_back((uint32_t)i + 1);
+        }
+        return;
+    }
+
+    // Gather corner positions; a missing position makes clipping meaningless
+    std::vector<float> px(n), py(n), pz(n);
+    size_t positionCount = positions.size() / 3;
+    bool valid = true;
+    for (size_t i = 0; i < n; i++) {
+        int idx = corners[i * 3];
+        if (idx < 0 || (size_t)idx >= positionCount) { valid = false; break; }
+        px[i] = positions[idx * 3 + 0];
+        py[i] = positions[idx * 3 + 1];
+        pz[i] = positions[idx * 3 + 2];
+    }
+
+    std::vector<uint32_t> remaining(n);
+    for (size_t i = 0; i < n; i++) remaining[i] = (uint32_t)i;
+
+    if (valid) {
+        // Newell normal, then project onto the plane of its two smallest axes
+        float nx = 0, ny = 0, nz = 0;
+        for (size_t i = 0; i < n; i++) {
+            size_t j = (i + 1) % n;
+            nx += (py[i] - py[j]) * (pz[i] + pz[j]);
+            ny += (pz[i] - pz[j]) * (px[i] + px[j]);
+            nz += (px[i] - px[j]) * (py[i] + py[j]);
+        }
+        float ax = std::fabs(nx), ay = std::fabs(ny), az = std::fabs(nz);
+        std::vector<float> u(n), v(n);
+        float sign;
+        for (size_t i = 0; i < n; i++) {
+            if (az >= ax && az >= ay)      { u[i] = px[i]; v[i] = py[i]; }
+            else if (ax >= ay)             { u[i] = py[i]; v[i] = pz[i]; }
+            else                           { u[i] = pz[i]; v[i] = px[i]; }
+        }
+        if (az >= ax && az >= ay) sign = nz >= 0 ? 1.0f : -1.0f;
+        else if (ax >= ay)        sign = nx >= 0 ? 1.0f : -1.0f;
+        else                      sign = ny >= 0 ? 1.0f : -1.0f;
+
+        auto cross = [&](uint32_t a, uint32_t b, uint32_t c) {
+            return sign * ((u[b] - u[a]) * (v[c] - v[a]) - (v[b] - v[a]) * (u[c] - u[a]));
+        };
+
+        size_t guard = 0;
+        size_t i = 0;
+        while (remaining.size() > 3 && guard < remaining.size()) {
+            size_t count = remaining.size();
+            uint32_t a = remaining[(i + count - 1) % count];
+            uint32_t b = remaining[i % count];
+            uint32_t c = remaining[(i + 1) % count];
+
+            bool isEar = cross(a, b, c) > 0.0f;
+            for (size_t k = 0; isEar && k < count; k++) {
+                uint32_t q = remaining[k];
+                if (q == a || q == b || q == c) continue;
+                if (cross(a, b, q) >= 0.0f && cross(b, c, q) >= 0.0f && cross(c, a, q) >= 0.0f) isEar = false;
+            }
+
+            if (isEar) {
+                triangles.push_back(a);
+                triangles.push_back(b);
+                triangles.push_back(c);
+                remaining.erase(remaining.begin() + (i % count));
+                guard = 0;
+            }
+            else {
+                i++;
+                guard++;
+            }
+        }
+    }
+
+    // Fan whatever is left (the last triangle, or everything on degenerate input)
+    for (size_t i = 1; i + 1 < remaining.size(); i++) {
+        triangles.push_back(remaining[0]);
+        triangles.push_back(remaining[i]);
+        triangles.push_back(remaining[i + 1]);
+    }
+}
+
+// Files smaller than this are parsed as one chunk; splitting costs more than it saves
+const size_t MIN_PARALLEL_CHUNK_BYTES = 64 * 1024;
+
+} // namespace
+
+bool parseOBJ(const char* data, size_t size, MeshData& out, ThreadPool* pool) {
+    size_t chunkCount = 1;
+    if (pool) {
+        chunkCount = std::min<size_t>(pool->size() + 1, size / MIN_PARALLEL_CHUNK_BYTES);
+        if (chunkCount < 1) chunkCount = 1;
+    }
+    std::vector<Chunk> chunks = splitIntoChunks(data, size, chunkCount);
+    auto forEachChunk = [&](const std::function<void(size_t)>& fn) {
+        if (pool && chunks.size() > 1) pool->parallelFor(chunks.size(), fn);
+        else for (size_t i = 0; i < chunks.size(); i++) fn(i);
+    };
+
+    // --- Pass 1: count elements per chunk ---
+    forEachChunk([&](size_t i) { countChunk(chunks[i]); });
+
+    // Prefix sums give every chunk its offset into the global arrays
+    size_t positionCount = 0, texcoordCount = 0, normalCount = 0;
+    size_t polygonCount = 0, cornerCount = 0, triangleCount = 0;
+    for (Chunk& chunk : chunks) {
+        chunk.positionBase = positionCount;   positionCount += chunk.positions;
+        chunk.texcoordBase = texcoordCount;   texcoordCount += chunk.texcoords;
+        chunk.normalBase = normalCount;       normalCount += chunk.normals;
+        chunk.polygonBase = polygonCount;     polygonCount += chunk.polygons;
+        chunk.cornerBase = cornerCount;       cornerCount += chunk.corners;
+        triangleCount += chunk.triangles;
+    }
+
+    if (polygonCount == 0) return false;
+
+    ParseArrays arrays;
+    arrays.temp_positions.resize(positionCount * 3);
+    arrays.temp_texcoords.resize(texcoordCount * 2);
+    arrays.temp_normals.resize(normalCount * 3);
+    arrays.temp_corners.resize(cornerCount * 3);
+    arrays.temp_polygonSizes.resize(polygonCount);
+
+    // --- Pass 2: parse every chunk into its own ranges ---
+    forEachChunk([&](size_t i) { parseChunk(chunks[i], arrays); });
+
+    // --- Pass 3: triangulate and deduplicate corners in file order, so the
+    // result does not depend on how the file was split. Triangles are grouped
+    // per material (in order of first use) so each usemtl becomes one range. ---
+    std::vector<MaterialSwitch> switches;
+    out.materialLibrary.clear();
+    for (Chunk& chunk : chunks) {
+        for (MaterialSwitch& change : chunk.materialSwitches) switches.push_back(std::move(change));
+        if (out.materialLibrary.empty()) out.materialLibrary = chunk.materialLibrary;
+    }
+
+    std::vector<std::string> materialNames;
+    std::vector<std::vector<uint32_t>> materialIndices;
+    auto materialSlot = [&](const std::string& name) {
+        for (size_t i = 0; i < materialNames.size(); i++) {
+            if (materialNames[i] == name) return i;
+        }
+        materialNames.push_back(name);
+        materialIndices.emplace_back();
+        return materialNames.size() - 1;
+    };
+
+    // Size each material's list for its own triangles (n - 2 per polygon),
+    // assigning the slots in the same order as the pass below
+    {
+        std::vector<size_t> materialTriangles;
+        size_t nextSwitch = 0;
+        size_t currentMaterial = SIZE_MAX;
+        for (size_t polygon = 0; polygon < polygonCount; polygon++) {
+            while (nextSwitch < switches.size() && switches[nextSwitch].polygon <= polygon) {
+                currentMaterial = materialSlot(switches[nextSwitch].name);
+                nextSwitch++;
+            }
+            if (currentMaterial == SIZE_MAX) currentMaterial = materialSlot("");
+            if (materialTriangles.size() < materialNames.size()) materialTriangles.resize(materialNames.size(), 0);
+            size_t n = arrays.temp_polygonSizes[polygon];
+            if (n >= 3) materialTriangles[currentMaterial] += n - 2;
+        }
+        for (size_t m = 0; m < materialTriangles.size(); m++) {
+            materialIndices[m].reserve(materialTriangles[m] * 3);
+        }
+    }
+
+    out.vertices.clear();
+    out.vertices.reserve(cornerCount);
+    CornerMap corners(cornerCount);
+
+    size_t nextSwitch = 0;
+    size_t currentMaterial = SIZE_MAX;
+    std::vector<uint32_t> triangles;
+    const int* polygonCorners = arrays.temp_corners.data();
+    for (size_t polygon = 0; polygon < polygonCount; polygon++) {
+        while (nextSwitch < switches.size() && switches[nextSwitch].polygon <= polygon) {
+            currentMaterial = materialSlot(switches[nextSwitch].name);
+            nextSwitch++;
+        }
+        if (currentMaterial == SIZE_MAX) currentMaterial = materialSlot("");
+
+        size_t n = arrays.temp_polygonSizes[polygon];
+        triangulatePolygon(polygonCorners, n, arrays.temp_positions, triangles);
+
+        std::vector<uint32_t>& indices = materialIndices[currentMaterial];
+        for (uint32_t local : triangles) {
+            const int* corner = polygonCorners + local * 3;
+            int posIdx = corner[0], texIdx = corner[1], normIdx = corner[2];
+
+            bool inserted;
+            uint32_t index = corners.findOrInsert(posIdx, texIdx, normIdx,
+                                                  (uint32_t)out.vertices.size(), inserted);
+            indices.push_back(index);
+            if (!inserted) continue;
+
+            Vertex vert;
+
+            // Set position
+            if (posIdx >= 0 && (size_t)posIdx < positionCount) {
+                vert.x = arrays.temp_positions[posIdx * 3 + 0];
+                vert.y = arrays.temp_positions[posIdx * 3 + 1];
+                vert.z = arrays.temp_positions[posIdx * 3 + 2];
+            } else {
+                vert.x = vert.y = vert.z = 0.0f;
+            }
+
+            // Set texture coordinates
+            if (texIdx >= 0 && (size_t)texIdx < texcoordCount) {
+                vert.u = arrays.temp_texcoords[texIdx * 2 + 0];
+                vert.v = arrays.temp_texcoords[texIdx * 2 + 1];
+            } else {
+                vert.u = vert.v = 0.0f;
+            }
+
+            // Set normals
+            if (normIdx >= 0 && (size_t)normIdx < normalCount) {
+                vert.nx = arrays.temp_normals[normIdx * 3 + 0];
+                vert.ny = arrays.temp_normals[normIdx * 3 + 1];
+                vert.nz = arrays.temp_normals[normIdx * 3 + 2];
+            } else {
+                vert.nx = 0.0f; vert.ny = 1.0f; vert.nz = 0.0f; // Default up
+            }
+
+            out.vertices.push_back(vert);
+        }
+        polygonCorners += n * 3;
+    }
+
+    // Concatenate the per-material triangle lists into submesh ranges
+    out.indices.clear();
+    out.indices.reserve(triangleCount * 3);
+    out.submeshes.clear();
+    for (size_t m = 0; m < materialNames.size(); m++) {
+        if (materialIndices[m].empty()) continue;
+        Submesh submesh = {};
+        submesh.firstIndex = (uint32_t)out.indices.size();
+        submesh.indexCount = (uint32_t)materialIndices[m].size();
+        std::strncpy(submesh.material, materialNames[m].c_str(), sizeof(submesh.material) - 1);
+        submesh.materialIndex = 0;
+        submesh.bounds = computeBounds(&out.vertices[0].x, sizeof(Vertex), materialIndices[m].data(), materialIndices[m].size());
+        out.submeshes.push_back(submesh);
+        out.indices.insert(out.indices.end(), materialIndices[m].begin(), materialIndices[m].end());
+    }
+
+    out.bounds = computeBounds(&out.vertices[0].x, out.vertices.size(), sizeof(Vertex));
+    return true;
+}
+
+// The getline/istringstream loader this parser replaced, kept as the baseline
+// for --bench-obj. Like the original it reads the file through a stream,
+// grows every array one element at a time and keeps only the first three
+// corners of a face. Returns the number of triangles.
+static size_t parseOBJStreamReference(const char* filepath, std::vector<Vertex>& vertices) {
+    std::vector<float> temp_positions;
+    std::vector<float> temp_texcoords;
+    std::vector<float> temp_normals;
+    vertices.clear();
+
+    std::ifstream file(filepath);
+    std::string line;
+    while (std::getline(file, line)) {
+        std::istringstream iss(line);
+        std::string prefix;
+        iss >> prefix;
+
+        if (prefix == "v") {
+            float x, y, z;
+            iss >> x >> y >> z;
+            temp_positions.push_back(x);
+            temp_positions.push_back(y);
+            temp_positions.push_back(z);
+        }
+        else if (prefix == "vt") {
+            float u, v;
+            iss >> u >> v;
+            temp_texcoords.push_back(u);
+            temp_texcoords.push_back(v);
+        }
+        else if (prefix == "vn") {
+            float nx, ny, nz;
+            iss >> nx >> ny >> nz;
+            temp_normals.push_back(nx);
+            temp_normals.push_back(ny);
+            temp_normals.push_back(nz);
+        }
+        else if (prefix == "f") {
+            std::string vertexData[3];
+            iss >> vertexData[0] >> vertexData[1] >> vertexData[2];
+
+            for (int i = 0; i < 3; i++) {
+                int posIdx = 0, texIdx = 0, normIdx = 0;
+                size_t slash1 = vertexData[i].find('/');
+                if (slash1 != std::string::npos) {
+                    posIdx = std::stoi(vertexData[i].substr(0, slash1));
+                    size_t slash2 = vertexData[i].find('/', slash1 + 1);
+                    if (slash2 != std::string::npos) {
+                        if (slash2 > slash1 + 1) texIdx = std::stoi(vertexData[i].substr(slash1 + 1, slash2 - slash1 - 1));
+                        normIdx = std::stoi(vertexData[i].substr(slash2 + 1));
+                    }
+                    else {
+                        texIdx = std::stoi(vertexData[i].substr(slash1 + 1));
+                    }
+                }
+                else {
+                    posIdx = std::stoi(vertexData[i]);
+                }
+                posIdx--; texIdx--; normIdx--;
+
+                Vertex vert = {};
+                if (posIdx >= 0 && posIdx * 3 + 2 < (int)temp_positions.size()) {
+                    vert.x = temp_positions[posIdx * 3 + 0];
+                    vert.y = temp_positions[posIdx * 3 + 1];
+                    vert.z = temp_positions[posIdx * 3 + 2];
+                }
+                if (texIdx >= 0 && texIdx * 2 + 1 < (int)temp_texcoords.size()) {
+                    vert.u = temp_texcoords[texIdx * 2 + 0];
+                    vert.v = temp_texcoords[texIdx * 2 + 1];
+                }
+                if (normIdx >= 0 && normIdx * 3 + 2 < (int)temp_normals.size()) {
+                    vert.nx = temp_normals[normIdx * 3 + 0];
+                    vert.ny = temp_normals[normIdx * 3 + 1];
+                    vert.nz = temp_normals[normIdx * 3 + 2];
+                }
+                else {
+                    vert.ny = 1.0f;
+                }
+                vertices.push_back(vert);
+            }
+        }
+    }
+    return vertices.size() / 3;
+}
+
+// Best of several runs to filter out page-cache and scheduler noise
+template <typename F>
+static double bestOfRuns(F&& body) {
+    const int runs = 5;
+    double bestMs = 1e30;
+    for (int run = 0; run < runs; run++) {
+        auto start = std::chrono::steady_clock::now();
+        body();
+        double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        bestMs = std::min(bestMs, ms);
+    }
+    return bestMs;
+}
+
+void benchmarkOBJParser(const char* filepath) {
+    MappedFile file;
+    if (!file.open(filepath)) {
+        std::cout << "ERROR: Could not open OBJ file: " << filepath << std::endl;
+        return;
+    }
+
+    // Both sides include opening the file, as a load does
+    std::vector<Vertex> streamVertices;
+    size_t streamTriangles = 0;
+    double streamMs = bestOfRuns([&]() { streamTriangles = parseOBJStreamReference(filepath, streamVertices); });
+    MeshData mapped;
+    double mappedMs = bestOfRuns([&]() {
+        MappedFile input;
+        if (input.open(filepath)) parseOBJ(input.data(), input.size(), mapped, nullptr);
+    });
+    std::cout << "OBJ parse of " << filepath << ": getline/istringstream " << streamMs << " ms (" << streamTriangles
+              << " triangles), mapped " << mappedMs << " ms (" << mapped.indices.size() / 3 << " triangles), speedup "
+              << streamMs / mappedMs << std::endl;
+
+    unsigned int maxThreads = std::max(1u, std::thread::hardware_concurrency());
+    std::cout << "OBJ parse scaling for " << filepath << " (" << file.size() << " bytes)" << std::endl;
+
+    MeshData reference;
+    parseOBJ(file.data(), file.size(), reference, nullptr);
+
+    double serialMs = 0.0;
+    for (unsigned int threads = 1; threads <= maxThreads; threads++) {
+        std::unique_ptr<ThreadPool> pool;
+        if (threads > 1) pool.reset(new ThreadPool(threads - 1));
+
+        MeshData mesh;
+        double bestMs = bestOfRuns([&]() { parseOBJ(file.data(), file.size(), mesh, pool.get()); });
+        if (threads == 1) serialMs = bestMs;
+
+        bool identical = mesh.indices == reference.indices && mesh.vertices.size() == reference.vertices.size() &&
+            std::memcmp(mesh.vertices.data(), reference.vertices.data(), mesh.vertices.size() * sizeof(Vertex)) == 0;
+
+        std::cout << "  " << threads << " thread(s): " << bestMs << " ms, speedup " << serialMs / bestMs
+                  << (identical ? "" : "  OUTPUT DIFFERS FROM SERIAL") << std::endl;
+    }
+}
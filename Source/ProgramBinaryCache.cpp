@@ -0,0 +1,86 @@
+#include "../Header/ProgramBinaryCache.h"
+#include "../Header/ContentHash.h"
+#include "../Header/MappedFile.h"
+#include <fstream>
+#include <filesystem>
+#include <vector>
+#include <cstdio>
+#include <cstring>
+
+static std::string glString(GLenum name) {
+    const GLubyte* value = glGetString(name);
+    return value ? reinterpret_cast<const char*>(value) : "";
+}
+
+uint64_t programBinaryKey(const std::string& vertexSource, const std::string& fragmentSource) {
+    // Separators keep "ab" + "c" and "a" + "bc" apart
+    std::string text;
+    for (const std::string& part : { glString(GL_VENDOR), glString(GL_RENDERER), glString(GL_VERSION), vertexSource, fragmentSource }) {
+        text += part;
+        text += '\0';
+    }
+    return hashBytes(text.data(), text.size());
+}
+
+std::string programBinaryPath(uint64_t key) {
+    char name[32];
+    snprintf(name, sizeof(name), "%016llx.bin", (unsigned long long)key);
+    return std::string(PROGRAM_CACHE_DIRECTORY) + "/" + name;
+}
+
+// Drivers may support the extension but offer no binary formats
+static bool programBinariesAvailable() {
+    if (!GLEW_ARB_get_program_binary) return false;
+    GLint formats = 0;
+    glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formats);
+    return formats > 0;
+}
+
+bool loadProgramBinary(unsigned int program, uint64_t key) {
+    if (!programBinariesAvailable()) return false;
+
+    MappedFile file;
+    if (!file.open(programBinaryPath(key).c_str())) return false;
+    if (file.size() < sizeof(ProgramBinaryHeader)) return false;
+
+    ProgramBinaryHeader header;
+    std::memcpy(&header, file.data(), sizeof(header));
+    if (header.magic != PROGRAM_BINARY_MAGIC || header.version != PROGRAM_BINARY_VERSION) return false;
+    if (header.key != key || header.size != file.size() - sizeof(header)) return false;
+
+    // The driver still validates the binary and fails the link if it does not accept it
+    glProgramBinary(program, header.binaryFormat, file.data() + sizeof(header), (GLsizei)header.size);
+    GLint linked = GL_FALSE;
+    glGetProgramiv(program, GL_LINK_STATUS, &linked);
+    return linked == GL_TRUE;
+}
+
+void requestProgramBinary(unsigned int program) {
+    if (GLEW_ARB_get_program_binary) glProgramParameteri(program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+}
+
+bool saveProgramBinary(unsigned int program, uint64_t key) {
+    if (!programBinariesAvailable()) return true;
+
+    GLint length = 0;
+    glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+    if (length <= 0) return false;
+
+    std::vector<char> binary(length);
+    ProgramBinaryHeader header = {};
+    GLenum binaryFormat = 0;
+    glGetProgramBinary(program, length, &length, &binaryFormat, binary.data());
+    header.magic = PROGRAM_BINARY_MAGIC;
+    header.version = PROGRAM_BINARY_VERSION;
+    header.key = key;
+    header.binaryFormat = binaryFormat;
+    header.size = (uint32_t)length;
+
+    std::error_code error;
+    std::filesystem::create_directories(PROGRAM_CACHE_DIRECTORY, error);
+    std::ofstream file(programBinaryPath(key), std::ios::binary | std::ios::trunc);
+    if (!file.is_open()) return false;
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    file.write(binary.data(), length);
+    return file.good();
+}
@@ -0,0 +1,219 @@
+#include "../Header/RenderQueue.h"
+#include "../Header/Model.h"
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtc/type_ptr.hpp>
+#include <algorithm>
+#include <cmath>
+
+void RenderQueue::submit(const GameObject& obj, int roundingMode) {
+    if (!obj.isVisible) return;
+
+    // Create model matrix (position, rotation, scale)
+    glm::mat4 model = glm::mat4(1.0f);
+    model = glm::translate(model, glm::vec3(obj.x, obj.y, obj.z));
+    if (obj.rotateX != 0.0f)
+        model = glm::rotate(model, glm::radians(obj.rotateX), glm::vec3(1.0f, 0.0f, 0.0f));
+    if (obj.rotateY != 0.0f)
+        model = glm::rotate(model, glm::radians(obj.rotateY), glm::vec3(0.0f, 1.0f, 0.0f));
+    if (obj.rotateZ != 0.0f)
+        model = glm::rotate(model, glm::radians(obj.rotateZ), glm::vec3(0.0f, 0.0f, 1.0f));
+    model = glm::scale(model, glm::vec3(obj.w, obj.h, obj.d));
+
+    QueuedObject queued;
+    queued.transform = model;
+    queued.model = obj.is3DModel ? obj.model : INVALID_MODEL;
+    queued.material = obj.materialIndex;
+    queued.texture = obj.useTexture ? obj.textureId : 0;
+    queued.rounding = roundingMode;
+
+    // An object's own material already carries its color
+    queued.tint = obj.materialIndex >= 0 ? glm::vec4(1.0f) : glm::vec4(obj.r, obj.g, obj.b, obj.a);
+
+    objects.push_back(queued);
+}
+
+// Planes (normal, distance) of the view frustum, pointing inwards (Gribb & Hartmann)
+static void extractFrustumPlanes(const glm::mat4& viewProjection, glm::vec4 planes[6]) {
+    glm::mat4 m = glm::transpose(viewProjection);
+    planes[0] = m[3] + m[0];    // Left
+    planes[1] = m[3] - m[0];    // Right
+    planes[2] = m[3] + m[1];    // Bottom
+    planes[3] = m[3] - m[1];    // Top
+    planes[4] = m[3] + m[2];    // Near
+    planes[5] = m[3] - m[2];    // Far
+    for (int i = 0; i < 6; i++) planes[i] /= glm::length(glm::vec3(planes[i]));
+}
+
+static bool sphereInFrustum(const glm::vec4 planes[6], const Bounds& bounds) {
+    glm::vec3 center(bounds.center[0], bounds.center[1], bounds.center[2]);
+    for (int i = 0; i < 6; i++) {
+        if (glm::dot(glm::vec3(planes[i]), center) + planes[i].w < -bounds.radius) return false;
+    }
+    return true;
+}
+
+size_t RenderQueue::selectLod(const Model& model, const Bounds& worldBounds, const Camera& camera, float viewportHeight) {
+    if (model.lods.size() < 2 || viewportHeight <= 0.0f || model.bounds.radius <= 0.0f) return 0;
+
+    // LOD errors are in object units; the sphere radii give the object's scale
+    float scale = worldBounds.radius / model.bounds.radius;
+
+    // Inside or touching the near plane: always full detail
+    glm::vec3 center(worldBounds.center[0], worldBounds.center[1], worldBounds.center[2]);
+    float distance = glm::length(center - camera.position) - worldBounds.radius;
+    if (distance <= camera.nearPlane) return 0;
+
+    // Pixels covered by one world unit at that distance
+    float pixelsPerUnit = viewportHeight / (2.0f * distance * std::tan(glm::radians(camera.fov) * 0.5f));
+
+    // Errors grow with the level, so the first level over budget ends the search
+    size_t level = 0;
+    for (size_t i = 1; i < model.lods.size(); i++) {
+        if (model.lods[i].error * scale * pixelsPerUnit > LOD_PIXEL_ERROR) break;
+        level = i;
+    }
+    return level;
+}
+
+void RenderQueue::flush(ShaderVariants& shaders, uint32_t passFeatures, unsigned int quadVAO, Camera& camera, float aspectRatio, ModelCache& cache) {
+    MaterialLibrary& materials = cache.getMaterials();
+    materials.upload();
+
+    // The shader reads the camera from the FrameData block; these are for culling and LOD selection
+    glm::mat4 view = camera.getViewMatrix();
+    glm::mat4 projection = camera.getProjectionMatrix(aspectRatio);
+
+    GLint viewport[4];
+    glGetIntegerv(GL_VIEWPORT, viewport);
+    float viewportHeight = (float)viewport[3];
+
+    glm::vec4 frustum[6];
+    extractFrustumPlanes(projection * view, frustum);
+
+    // Expand visible objects into one draw per submesh of the selected LOD
+    lastTriangleCount = 0;
+    lastCulledCount = 0;
+    for (const QueuedObject& obj : objects) {
+        DrawItem item = {};
+        item.model = obj.transform;
+        item.texture = obj.texture;
+        item.rounding = obj.rounding;
+        item.tint = obj.tint;
+
+        const Model* found = cache.getModel(obj.model);
+        if (!found) {
+            // 2D quad (backward compatible)
+            item.material = obj.material >= 0 ? (uint32_t)obj.material : 0;
+            item.order = (uint32_t)items.size();
+            items.push_back(item);
+            lastTriangleCount += 2;
+            continue;
+        }
+
+        // Models still loading in the background draw as a cube of the object's size;
+        // evicted ones are loaded again as soon as something draws them
+        if (found->status == MODEL_EVICTED) cache.requestModel(obj.model);
+        const Model& modelData = found->status == MODEL_READY ? *found : cache.getPlaceholder();
+        Bounds worldBounds = transformBounds(modelData.bounds, obj.transform);
+        if (!sphereInFrustum(frustum, worldBounds)) {
+            lastCulledCount++;
+            continue;
+        }
+        cache.touchModel(obj.model);
+
+        size_t firstSubmesh = 0;
+        size_t submeshCount = modelData.submeshes.size();
+        if (!modelData.lods.empty()) {
+            const MeshLod& lod = modelData.lods[selectLod(modelData, worldBounds, camera, viewportHeight)];
+            firstSubmesh = lod.firstSubmesh;
+            submeshCount = lod.submeshCount;
+        }
+
+        if (modelData.packed) {
+            // Packed positions are in [-1, 1]; scale and offset them back to object space
+            const float* offset = modelData.positionOffset;
+            item.model = glm::translate(item.model, glm::vec3(offset[0], offset[1], offset[2]));
+            item.model = glm::scale(item.model, glm::vec3(modelData.positionScale));
+        }
+        item.VAO = modelData.VAO;
+        item.indexType = modelData.indexType;
+        item.baseVertex = modelData.geometry.baseVertex;
+        size_t indexSize = (modelData.indexType == GL_UNSIGNED_SHORT) ? 2 : 4;
+        for (size_t i = firstSubmesh; i < firstSubmesh + submeshCount; i++) {
+            const Submesh& submesh = modelData.submeshes[i];
+            if (submesh.indexCount == 0) continue;
+            if (submeshCount > 1 && !sphereInFrustum(frustum, transformBounds(submesh.bounds, obj.transform))) continue;
+            item.indexOffset = modelData.geometry.indexOffset + (uint64_t)submesh.firstIndex * indexSize;
+            item.indexCount = submesh.indexCount;
+            item.material = obj.material >= 0 ? (uint32_t)obj.material : submesh.materialIndex;
+            item.order = (uint32_t)items.size();
+            items.push_back(item);
+            lastTriangleCount += submesh.indexCount / 3;
+        }
+    }
+
+    for (DrawItem& item : items) {
+        // Materials with a map_Kd supply the texture when the object has none
+        if (item.texture == 0) item.texture = materials.diffuseTexture(item.material);
+        item.blended = item.tint.a < 1.0f || materials.get(item.material).diffuse[3] < 1.0f;
+        item.features = shaderFeatures(passFeatures, item.texture, item.rounding);
+        item.sortKey = ((uint64_t)item.features << 56) |
+                       ((uint64_t)(item.material & 0xFF) << 48) |
+                       ((uint64_t)(item.texture & 0xFFFF) << 32) |
+                       ((uint64_t)(item.VAO & 0xFFFF) << 16) |
+                       (uint64_t)(item.rounding & 0xFFFF);
+    }
+
+    // Without depth testing the submission order is the visible order
+    if (glIsEnabled(GL_DEPTH_TEST)) {
+        std::sort(items.begin(), items.end(), [](const DrawItem& a, const DrawItem& b) {
+            if (a.blended != b.blended) return !a.blended;
+            if (a.blended) return a.order < b.order;
+            if (a.sortKey != b.sortKey) return a.sortKey < b.sortKey;
+            return a.order < b.order;
+        });
+    }
+
+    // Each variant skips uniform uploads whose value did not change
+    ShaderProgram* shader = nullptr;
+    uint32_t currentFeatures = UINT32_MAX;
+    unsigned int currentTexture = UINT32_MAX;
+    unsigned int currentVAO = UINT32_MAX;
+
+    for (const DrawItem& item : items) {
+        if (item.features != currentFeatures) {
+            shader = &shaders.get(item.features);
+            shader->use();
+            currentFeatures = item.features;
+        }
+        shader->set(UNIFORM_MODEL, item.model);
+        shader->set(UNIFORM_MATERIAL_INDEX, (int)item.material);
+        shader->set(UNIFORM_COLOR, item.tint);
+        shader->set(UNIFORM_ROUNDING, item.rounding);
+        if (item.texture != currentTexture) {
+            if (item.texture != 0) {
+                glActiveTexture(GL_TEXTURE0);
+                glBindTexture(GL_TEXTURE_2D, item.texture);
+            }
+            currentTexture = item.texture;
+        }
+
+        unsigned int vao = item.VAO != 0 ? item.VAO : quadVAO;
+        if (vao != currentVAO) {
+            glBindVertexArray(vao);
+            currentVAO = vao;
+        }
+
+        if (item.VAO != 0) {
+            // Models share the arena buffers; indices are relative to the model's first vertex
+            glDrawElementsBaseVertex(GL_TRIANGLES, item.indexCount, item.indexType, (void*)item.indexOffset, item.baseVertex);
+        }
+        else {
+            glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+        }
+    }
+
+    glBindVertexArray(0);
+    objects.clear();
+    items.clear();
+}
@@ -0,0 +1,134 @@
+#include "../Header/ShaderBuildQueue.h"
+#include "../Header/ProgramBinaryCache.h"
+#include <iostream>
+#include <utility>
+
+bool ShaderBuildQueue::parallelCompileAvailable() {
+    return GLEW_KHR_parallel_shader_compile;
+}
+
+// Once per context: let the driver pick how many threads it compiles on
+static void enableParallelCompile() {
+    static bool enabled = false;
+    if (enabled || !ShaderBuildQueue::parallelCompileAvailable()) return;
+    glMaxShaderCompilerThreadsKHR(0xFFFFFFFFu);
+    enabled = true;
+}
+
+// No status query, so the driver may still be compiling when this returns
+static unsigned int startCompile(GLenum type, const std::string& code) {
+    const char* sourceCode = code.c_str();
+    unsigned int shader = glCreateShader(type);
+    glShaderSource(shader, 1, &sourceCode, NULL);
+    glCompileShader(shader);
+    return shader;
+}
+
+static void printCompileLog(unsigned int shader, const char* stage) {
+    GLint compiled = GL_FALSE;
+    glGetShaderiv(shader, GL_COMPILE_STATUS, &compiled);
+    if (compiled == GL_TRUE) return;
+    char infoLog[512];
+    glGetShaderInfoLog(shader, sizeof(infoLog), NULL, infoLog);
+    std::cout << "ERROR: " << stage << " shader failed to compile: " << infoLog << std::endl;
+}
+
+ShaderBuildQueue::~ShaderBuildQueue() {
+    clear();
+}
+
+ShaderBuildTicket ShaderBuildQueue::submit(const std::string& vertexCode, const std::string& fragmentCode) {
+    enableParallelCompile();
+
+    Build build;
+    build.program = glCreateProgram();
+    build.vertexShader = 0;
+    build.fragmentShader = 0;
+    build.binaryKey = programBinaryKey(vertexCode, fragmentCode);
+    build.done = false;
+
+    // A binary saved by an earlier run with the same sources and driver skips compiling and linking
+    if (loadProgramBinary(build.program, build.binaryKey)) {
+        build.done = true;
+        build.result = ShaderProgram(build.program);
+    }
+    else {
+        build.vertexShader = startCompile(GL_VERTEX_SHADER, vertexCode);
+        build.fragmentShader = startCompile(GL_FRAGMENT_SHADER, fragmentCode);
+        glAttachShader(build.program, build.vertexShader);
+        glAttachShader(build.program, build.fragmentShader);
+        requestProgramBinary(build.program);
+        glLinkProgram(build.program);
+        pendingCount++;
+    }
+
+    builds.push_back(std::move(build));
+    return (ShaderBuildTicket)(builds.size() - 1);
+}
+
+void ShaderBuildQueue::finish(Build& build) {
+    GLint linked = GL_FALSE;
+    glGetProgramiv(build.program, GL_LINK_STATUS, &linked);
+    if (linked == GL_FALSE) {
+        // Only a failed build is worth the per-stage queries
+        printCompileLog(build.vertexShader, "Vertex");
+        printCompileLog(build.fragmentShader, "Fragment");
+        char infoLog[512];
+        glGetProgramInfoLog(build.program, sizeof(infoLog), NULL, infoLog);
+        std::cout << "ERROR: Shader program failed to link: " << infoLog << std::endl;
+    }
+    else if (!saveProgramBinary(build.program, build.binaryKey)) {
+        std::cout << "WARNING: Could not write program binary: " << programBinaryPath(build.binaryKey) << std::endl;
+    }
+
+    // The linked program keeps the code; the stage objects are no longer needed
+    glDetachShader(build.program, build.vertexShader);
+    glDeleteShader(build.vertexShader);
+    glDetachShader(build.program, build.fragmentShader);
+    glDeleteShader(build.fragmentShader);
+    build.vertexShader = 0;
+    build.fragmentShader = 0;
+
+    // Uniform locations are looked up once here instead of on every draw
+    build.result = ShaderProgram(build.program);
+    build.done = true;
+    pendingCount--;
+}
+
+bool ShaderBuildQueue::poll() {
+    bool parallel = parallelCompileAvailable();
+    for (Build& build : builds) {
+        if (pendingCount == 0) break;
+        if (build.done) continue;
+
+        if (parallel) {
+            GLint complete = GL_FALSE;
+            glGetProgramiv(build.program, GL_COMPLETION_STATUS_KHR, &complete);
+            if (complete == GL_FALSE) continue;
+            finish(build);
+        }
+        else {
+            // No way to ask without waiting, so wait for one
+            finish(build);
+            break;
+        }
+    }
+    return pendingCount == 0;
+}
+
+ShaderProgram ShaderBuildQueue::take(ShaderBuildTicket ticket) {
+    Build& build = builds[ticket];
+    if (!build.done) finish(build);
+    return std::move(build.result);
+}
+
+void ShaderBuildQueue::clear() {
+    for (Build& build : builds) {
+        if (build.done) continue;
+        glDeleteShader(build.vertexShader);
+        glDeleteShader(build.fragmentShader);
+        glDeleteProgram(build.program);
+    }
+    builds.clear();
+    pendingCount = 0;
+}
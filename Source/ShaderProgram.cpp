@@ -0,0 +1,132 @@
+#include "../Header/ShaderProgram.h"
+#include <glm/gtc/type_ptr.hpp>
+#include <iostream>
+#include <vector>
+#include <cstring>
+
+const char* const UNIFORM_SLOT_NAMES[UNIFORM_SLOT_COUNT] = {
+    "uModel",
+    "uColor",
+    "uTexture",
+    "uRounding",
+    "uMaterialIndex"
+};
+
+ShaderProgram::ShaderProgram(unsigned int program) : id(program) {
+    invalidate();
+    reflect();
+}
+
+ShaderProgram::~ShaderProgram() {
+    destroy();
+}
+
+ShaderProgram::ShaderProgram(ShaderProgram&& other) noexcept : id(other.id), locations(std::move(other.locations)) {
+    std::memcpy(slots, other.slots, sizeof(slots));
+    other.id = 0;
+    other.invalidate();
+}
+
+ShaderProgram& ShaderProgram::operator=(ShaderProgram&& other) noexcept {
+    if (this != &other) {
+        destroy();
+        id = other.id;
+        locations = std::move(other.locations);
+        std::memcpy(slots, other.slots, sizeof(slots));
+        other.id = 0;
+        other.invalidate();
+    }
+    return *this;
+}
+
+// Enumerate the active uniforms and resolve the slots
+void ShaderProgram::reflect() {
+    locations.clear();
+    for (Uniform& slot : slots) {
+        slot.location = -1;
+        slot.type = 0;
+    }
+    if (id == 0) return;
+
+    GLint count = 0, maxLength = 0;
+    glGetProgramiv(id, GL_ACTIVE_UNIFORMS, &count);
+    glGetProgramiv(id, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxLength);
+    std::vector<char> name(maxLength > 0 ? maxLength : 1);
+
+    for (GLint i = 0; i < count; i++) {
+        GLsizei length = 0;
+        GLint size = 0;
+        GLenum type = 0;
+        glGetActiveUniform(id, (GLuint)i, (GLsizei)name.size(), &length, &size, &type, name.data());
+        std::string uniformName(name.data(), length);
+        if (uniformName.size() > 3 && uniformName.compare(uniformName.size() - 3, 3, "[0]") == 0) {
+            uniformName.resize(uniformName.size() - 3);
+        }
+
+        // Members of uniform blocks have no location
+        GLint uniformLocation = glGetUniformLocation(id, uniformName.c_str());
+        if (uniformLocation < 0) continue;
+        locations[uniformName] = uniformLocation;
+
+        for (int slot = 0; slot < UNIFORM_SLOT_COUNT; slot++) {
+            if (uniformName == UNIFORM_SLOT_NAMES[slot]) {
+                slots[slot].location = uniformLocation;
+                slots[slot].type = type;
+            }
+        }
+    }
+}
+
+GLint ShaderProgram::location(const char* name) const {
+    auto it = locations.find(name);
+    return it != locations.end() ? it->second : -1;
+}
+
+// Record value for the slot; false if the uniform is inactive or already holds it
+bool ShaderProgram::changed(UniformSlot slot, const void* value, uint32_t words) {
+    Uniform& uniform = slots[slot];
+    if (uniform.location < 0) return false;
+    if (uniform.size == words && std::memcmp(uniform.value, value, words * sizeof(uint32_t)) == 0) return false;
+    uniform.size = words;
+    std::memcpy(uniform.value, value, words * sizeof(uint32_t));
+    return true;
+}
+
+void ShaderProgram::set(UniformSlot slot, int value) {
+    if (changed(slot, &value, 1)) glUniform1i(slots[slot].location, value);
+}
+
+void ShaderProgram::set(UniformSlot slot, float value) {
+    if (changed(slot, &value, 1)) glUniform1f(slots[slot].location, value);
+}
+
+void ShaderProgram::set(UniformSlot slot, const glm::vec3& value) {
+    if (changed(slot, glm::value_ptr(value), 3)) glUniform3fv(slots[slot].location, 1, glm::value_ptr(value));
+}
+
+void ShaderProgram::set(UniformSlot slot, const glm::vec4& value) {
+    if (changed(slot, glm::value_ptr(value), 4)) glUniform4fv(slots[slot].location, 1, glm::value_ptr(value));
+}
+
+void ShaderProgram::set(UniformSlot slot, const glm::mat4& value) {
+    if (changed(slot, glm::value_ptr(value), 16)) glUniformMatrix4fv(slots[slot].location, 1, GL_FALSE, glm::value_ptr(value));
+}
+
+void ShaderProgram::invalidate() {
+    for (Uniform& slot : slots) {
+        slot.size = 0;
+    }
+    if (id == 0) {
+        for (Uniform& slot : slots) {
+            slot.location = -1;
+            slot.type = 0;
+        }
+    }
+}
+
+void ShaderProgram::destroy() {
+    if (id != 0) glDeleteProgram(id);
+    id = 0;
+    locations.clear();
+    invalidate();
+}
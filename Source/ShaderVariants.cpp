@@ -0,0 +1,100 @@
+#include "../Header/ShaderVariants.h"
+#include "../Header/Util.h"
+#include <iostream>
+
+const char* const SHADER_FEATURE_DEFINES[SHADER_FEATURE_COUNT] = {
+    "TEXTURED",
+    "LIT",
+    "ROUNDED"
+};
+
+std::string shaderVariantSource(const std::string& source, uint32_t features) {
+    std::string defines;
+    for (uint32_t bit = 0; bit < SHADER_FEATURE_COUNT; bit++) {
+        if (features & (1u << bit)) {
+            defines += "#define ";
+            defines += SHADER_FEATURE_DEFINES[bit];
+            defines += "\n";
+        }
+    }
+
+    // #version has to stay the first statement
+    size_t version = source.find("#version");
+    if (version == std::string::npos) return defines + source;
+    size_t lineEnd = source.find('\n', version);
+    if (lineEnd == std::string::npos) return source + "\n" + defines;
+    return source.substr(0, lineEnd + 1) + defines + source.substr(lineEnd + 1);
+}
+
+ShaderVariants::ShaderVariants() {
+    for (ShaderBuildTicket& ticket : tickets) {
+        ticket = INVALID_SHADER_BUILD;
+    }
+}
+
+bool ShaderVariants::load(const char* vsPath, const char* fsPath) {
+    destroy();
+    vertexSource = readShaderFile(vsPath);
+    fragmentSource = readShaderFile(fsPath);
+    return !vertexSource.empty() && !fragmentSource.empty();
+}
+
+static void applyBlockBinding(unsigned int program, const std::string& block, GLuint binding) {
+    GLuint blockIndex = glGetUniformBlockIndex(program, block.c_str());
+    if (blockIndex != GL_INVALID_INDEX) glUniformBlockBinding(program, blockIndex, binding);
+}
+
+void ShaderVariants::setBlockBinding(const char* block, GLuint binding) {
+    blockBindings.emplace_back(block, binding);
+    for (const ShaderProgram& program : programs) {
+        if (program.isValid()) applyBlockBinding(program.getId(), block, binding);
+    }
+}
+
+void ShaderVariants::request(uint32_t features) {
+    if (programs[features].isValid() || tickets[features] != INVALID_SHADER_BUILD) return;
+    tickets[features] = queue.submit(shaderVariantSource(vertexSource, features),
+                                     shaderVariantSource(fragmentSource, features));
+}
+
+void ShaderVariants::requestAll() {
+    for (uint32_t features = 0; features < SHADER_VARIANT_COUNT; features++) {
+        request(features);
+    }
+}
+
+void ShaderVariants::adopt(uint32_t features) {
+    ShaderProgram& program = programs[features];
+    program = queue.take(tickets[features]);
+    tickets[features] = INVALID_SHADER_BUILD;
+    for (const auto& binding : blockBindings) {
+        applyBlockBinding(program.getId(), binding.first, binding.second);
+    }
+}
+
+bool ShaderVariants::poll() {
+    queue.poll();
+    bool building = false;
+    for (uint32_t features = 0; features < SHADER_VARIANT_COUNT; features++) {
+        if (tickets[features] == INVALID_SHADER_BUILD) continue;
+        if (queue.isReady(tickets[features])) adopt(features);
+        else building = true;
+    }
+    return !building;
+}
+
+ShaderProgram& ShaderVariants::get(uint32_t features) {
+    if (!programs[features].isValid()) {
+        request(features);
+        adopt(features);
+    }
+    return programs[features];
+}
+
+void ShaderVariants::destroy() {
+    queue.clear();
+    for (uint32_t features = 0; features < SHADER_VARIANT_COUNT; features++) {
+        programs[features].destroy();
+        tickets[features] = INVALID_SHADER_BUILD;
+    }
+}
@@ -0,0 +1,187 @@
+#include "../Header/TextureAtlas.h"
+#include "../Header/Util.h"
+#include "../Header/CookedTexture.h"
+#include <iostream>
+#include <algorithm>
+#include <cstring>
+
+// An image waiting to be packed, with its own mip chain
+struct AtlasImage {
+    std::string name;
+    TextureData data;
+    uint32_t cellX, cellY;       // Cell = image plus padding on every side
+    uint32_t cellWidth, cellHeight;
+};
+
+static uint32_t alignUp(uint32_t value, uint32_t alignment) {
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+// Place the cells on shelves, tallest first; false if they do not fit
+static bool packShelves(std::vector<AtlasImage>& images, const std::vector<size_t>& order, uint32_t width, uint32_t height) {
+    uint32_t x = 0, y = 0, shelfHeight = 0;
+    for (size_t i : order) {
+        AtlasImage& image = images[i];
+        if (image.cellWidth > width) return false;
+        if (x + image.cellWidth > width) {
+            y += shelfHeight;
+            x = 0;
+            shelfHeight = 0;
+        }
+        if (y + image.cellHeight > height) return false;
+        image.cellX = x;
+        image.cellY = y;
+        x += image.cellWidth;
+        shelfHeight = std::max(shelfHeight, image.cellHeight);
+    }
+    return true;
+}
+
+TextureAtlas::~TextureAtlas() {
+    clear();
+}
+
+bool TextureAtlas::build(const std::vector<std::string>& paths, uint32_t padding, uint32_t maxSize) {
+    clear();
+
+    // Images start on multiples of the coarsest level's texel
+    const uint32_t alignment = 1u << (ATLAS_MIP_LEVELS - 1);
+    padding = alignUp(padding, alignment);
+
+    std::vector<AtlasImage> images;
+    for (const std::string& path : paths) {
+        int w, h, channels;
+        unsigned char* decoded = decodeImage(path.c_str(), &w, &h, &channels);
+        if (!decoded) {
+            std::cout << "ERROR: Could not load atlas image: " << path << std::endl;
+            continue;
+        }
+
+        // Everything in the atlas is RGBA
+        std::vector<unsigned char> rgba((size_t)w * h * 4);
+        for (size_t i = 0; i < (size_t)w * h; i++) {
+            const unsigned char* texel = decoded + i * channels;
+            unsigned char* out = rgba.data() + i * 4;
+            out[0] = texel[0];
+            out[1] = channels >= 3 ? texel[1] : texel[0];
+            out[2] = channels >= 3 ? texel[2] : texel[0];
+            out[3] = channels == 4 ? texel[3] : (channels == 2 ? texel[1] : 255);
+        }
+        freeImage(decoded);
+
+        AtlasImage image;
+        image.name = path;
+        buildMipChain(rgba.data(), w, h, 4, image.data);
+        images.push_back(std::move(image));
+    }
+
+    AtlasImage white;
+    white.name = ATLAS_WHITE_REGION;
+    std::vector<unsigned char> whiteTexels(alignment * alignment * 4, 255);
+    buildMipChain(whiteTexels.data(), alignment, alignment, 4, white.data);
+    images.push_back(std::move(white));
+
+    // Smallest power-of-two size the shelves fit in: big enough for the widest
+    // and tallest cell and their total area, then growing the shorter side
+    std::vector<size_t> order(images.size());
+    uint32_t atlasWidth = alignment, atlasHeight = alignment;
+    uint64_t area = 0;
+    for (size_t i = 0; i < images.size(); i++) {
+        AtlasImage& image = images[i];
+        image.cellWidth = alignUp(image.data.width + 2 * padding, alignment);
+        image.cellHeight = alignUp(image.data.height + 2 * padding, alignment);
+        area += (uint64_t)image.cellWidth * image.cellHeight;
+        while (atlasWidth < image.cellWidth) atlasWidth *= 2;
+        while (atlasHeight < image.cellHeight) atlasHeight *= 2;
+        order[i] = i;
+    }
+    std::stable_sort(order.begin(), order.end(), [&images](size_t a, size_t b) {
+        return images[a].cellHeight > images[b].cellHeight;
+    });
+
+    while ((uint64_t)atlasWidth * atlasHeight < area || !packShelves(images, order, atlasWidth, atlasHeight)) {
+        if (atlasWidth > maxSize || atlasHeight > maxSize) break;
+        if (atlasWidth <= atlasHeight) atlasWidth *= 2;
+        else atlasHeight *= 2;
+    }
+    if (atlasWidth > maxSize || atlasHeight > maxSize) {
+        std::cout << "ERROR: Atlas images do not fit in " << maxSize << "x" << maxSize << std::endl;
+        return false;
+    }
+
+    // Copy every level of every image into the matching atlas level, repeating
+    // its edge texels over the padding
+    std::vector<std::vector<unsigned char>> levels(ATLAS_MIP_LEVELS);
+    for (uint32_t level = 0; level < ATLAS_MIP_LEVELS; level++) {
+        levels[level].assign((size_t)(atlasWidth >> level) * (atlasHeight >> level) * 4, 0);
+    }
+    for (const AtlasImage& image : images) {
+        for (uint32_t level = 0; level < ATLAS_MIP_LEVELS; level++) {
+            const CookedTextureLevel& source = image.data.levels[std::min<size_t>(level, image.data.levels.size() - 1)];
+            const unsigned char* in = image.data.pixels.data() + source.offset;
+            unsigned char* out = levels[level].data();
+            uint32_t levelWidth = atlasWidth >> level;
+            uint32_t levelPadding = padding >> level;
+            uint32_t originX = (image.cellX + padding) >> level;
+            uint32_t originY = (image.cellY + padding) >> level;
+
+            for (int32_t y = -(int32_t)levelPadding; y < (int32_t)(source.height + levelPadding); y++) {
+                int32_t sy = std::min(std::max(y, 0), (int32_t)source.height - 1);
+                for (int32_t x = -(int32_t)levelPadding; x < (int32_t)(source.width + levelPadding); x++) {
+                    int32_t sx = std::min(std::max(x, 0), (int32_t)source.width - 1);
+                    std::memcpy(out + ((size_t)(originY + y) * levelWidth + originX + x) * 4, in + ((size_t)sy * source.width + sx) * 4, 4);
+                }
+            }
+        }
+
+        AtlasRegion region;
+        region.name = image.name;
+        region.x = image.cellX + padding;
+        region.y = image.cellY + padding;
+        region.width = image.data.width;
+        region.height = image.data.height;
+        region.u0 = (float)region.x / atlasWidth;
+        region.v0 = (float)region.y / atlasHeight;
+        region.u1 = (float)(region.x + region.width) / atlasWidth;
+        region.v1 = (float)(region.y + region.height) / atlasHeight;
+        lookup[region.name] = regions.size();
+        regions.push_back(region);
+    }
+
+    width = atlasWidth;
+    height = atlasHeight;
+    glGenTextures(1, &id);
+    glBindTexture(GL_TEXTURE_2D, id);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    if (GLEW_ARB_texture_storage) {
+        glTexStorage2D(GL_TEXTURE_2D, ATLAS_MIP_LEVELS, GL_RGBA8, width, height);
+        for (uint32_t level = 0; level < ATLAS_MIP_LEVELS; level++) {
+            glTexSubImage2D(GL_TEXTURE_2D, level, 0, 0, width >> level, height >> level, GL_RGBA, GL_UNSIGNED_BYTE, levels[level].data());
+        }
+    }
+    else {
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, ATLAS_MIP_LEVELS - 1);
+        for (uint32_t level = 0; level < ATLAS_MIP_LEVELS; level++) {
+            glTexImage2D(GL_TEXTURE_2D, level, GL_RGBA8, width >> level, height >> level, 0, GL_RGBA, GL_UNSIGNED_BYTE, levels[level].data());
+        }
+    }
+    glBindTexture(GL_TEXTURE_2D, 0);
+    return true;
+}
+
+const AtlasRegion* TextureAtlas::find(const char* name) const {
+    auto it = lookup.find(name);
+    return it != lookup.end() ? &regions[it->second] : nullptr;
+}
+
+void TextureAtlas::clear() {
+    if (id != 0) glDeleteTextures(1, &id);
+    id = 0;
+    width = 0;
+    height = 0;
+    regions.clear();
+    lookup.clear();
+}
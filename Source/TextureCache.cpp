@@ -0,0 +1,411 @@
+#include "../Header/TextureCache.h"
+#include "../Header/Util.h"
+#include "../Header/ThreadPool.h"
+#include "../Header/LockFreeQueue.h"
+#include "../Header/CookedTexture.h"
+#include "../Header/ContentHash.h"
+#include "../Header/MappedFile.h"
+#include "../Header/TextureCompression.h"
+#include <iostream>
+#include <thread>
+#include <chrono>
+#include <cstring>
+
+// Texture data prepared off the GL thread, waiting for its upload
+struct PendingImage {
+    std::string path;
+    TextureHandle handle = INVALID_TEXTURE;  // Slot to fill (background loads)
+    std::string cookedPath;
+    bool loaded = false;
+    bool fromCooked = false;
+    bool cookWriteFailed = false;
+    TextureCookOptions options;
+    uint32_t supportedCompression = 0;
+    CookedTexture cooked;    // Valid when fromCooked
+    TextureData data;        // Valid otherwise
+
+    // The levels to upload, in the mapping or in data
+    CookedTextureHeader info = {};
+    const CookedTextureLevel* levels = nullptr;
+    const unsigned char* pixels = nullptr;
+};
+
+// Map the cooked texture if it is up to date, otherwise decode the image, build
+// its mip chain, compress it and write a fresh cooked texture next to it. Touches
+// only files, never OpenGL, so it is safe to run on worker threads.
+static void prepareImage(PendingImage& pending) {
+    MappedFile file;
+    if (!file.open(pending.path.c_str())) return;
+    uint64_t sourceHash = hashBytes(file.data(), file.size());
+    pending.cookedPath = cookedTexturePath(pending.path.c_str());
+
+    if (pending.cooked.open(pending.cookedPath.c_str(), sourceHash, file.size(), pending.options, pending.supportedCompression)) {
+        pending.fromCooked = true;
+        pending.info = pending.cooked.info();
+        pending.levels = pending.cooked.levels();
+        pending.pixels = pending.cooked.pixels();
+    }
+    else {
+        int width, height, channels;
+        unsigned char* image = decodeImage(pending.path.c_str(), &width, &height, &channels);
+        if (!image) return;
+        buildMipChain(image, width, height, channels, pending.data);
+        freeImage(image);
+        TextureCompression compression = resolveCompression(pending.options.compression, pending.data, pending.supportedCompression);
+        compressTexture(pending.data, compression, pending.options.quality);
+        pending.cookWriteFailed = !writeCookedTexture(pending.cookedPath.c_str(), sourceHash, file.size(), pending.data,
+                                                      pending.options, pending.supportedCompression);
+
+        const TextureData& data = pending.data;
+        pending.info.width = data.width;
+        pending.info.height = data.height;
+        pending.info.channels = data.channels;
+        pending.info.levelCount = (uint32_t)data.levels.size();
+        pending.info.internalFormat = data.internalFormat;
+        pending.info.format = data.format;
+        pending.info.type = GL_UNSIGNED_BYTE;
+        pending.info.compression = data.compression;
+        pending.info.dataSize = data.pixels.size();
+        pending.levels = data.levels.data();
+        pending.pixels = data.pixels.data();
+    }
+    pending.loaded = true;
+}
+
+bool cookTexture(const char* imagePath, const TextureCookOptions& options, uint32_t supportedCompression) {
+    PendingImage pending;
+    pending.path = imagePath;
+    pending.options = options;
+    pending.supportedCompression = supportedCompression;
+    prepareImage(pending);
+    return pending.loaded && !pending.cookWriteFailed;
+}
+
+TextureCache::TextureCache()
+    : fallback(0), supportedCompression(~0u), finished(std::make_shared<PendingImageQueue>(TEXTURE_LOAD_QUEUE_CAPACITY)), loadsInFlight(0),
+      uploadBuffers(), nextUploadBuffer(0) {}
+
+TextureCache::~TextureCache() {
+    clear();
+}
+
+// Create the texture with immutable storage when the driver has it and upload
+// every level. pixels is a client pointer, or 0 when the levels are in the bound
+// pixel unpack buffer.
+void TextureCache::createTexture(Texture& texture, const PendingImage& image, const unsigned char* pixels) {
+    const CookedTextureHeader& info = image.info;
+    texture.width = (int)info.width;
+    texture.height = (int)info.height;
+    texture.channels = (int)info.channels;
+    texture.format = info.format;
+    texture.internalFormat = info.internalFormat;
+    texture.compression = (TextureCompression)info.compression;
+    texture.mipLevels = info.levelCount;
+    texture.gpuBytes = info.dataSize;
+
+    glGenTextures(1, &texture.id);
+    glBindTexture(GL_TEXTURE_2D, texture.id);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+
+    // Levels are tightly packed; rows of odd-width RGB levels are not 4-byte aligned
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    bool compressed = info.compression != TEXTURE_COMPRESSION_NONE;
+    if (GLEW_ARB_texture_storage) {
+        glTexStorage2D(GL_TEXTURE_2D, info.levelCount, info.internalFormat, info.width, info.height);
+        for (uint32_t level = 0; level < info.levelCount; level++) {
+            const CookedTextureLevel& data = image.levels[level];
+            const void* source = (const void*)((uintptr_t)pixels + data.offset);
+            if (compressed) glCompressedTexSubImage2D(GL_TEXTURE_2D, level, 0, 0, data.width, data.height, info.internalFormat, (GLsizei)data.size, source);
+            else glTexSubImage2D(GL_TEXTURE_2D, level, 0, 0, data.width, data.height, info.format, info.type, source);
+        }
+    }
+    else {
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, info.levelCount - 1);
+        for (uint32_t level = 0; level < info.levelCount; level++) {
+            const CookedTextureLevel& data = image.levels[level];
+            const void* source = (const void*)((uintptr_t)pixels + data.offset);
+            if (compressed) glCompressedTexImage2D(GL_TEXTURE_2D, level, info.internalFormat, data.width, data.height, 0, (GLsizei)data.size, source);
+            else glTexImage2D(GL_TEXTURE_2D, level, info.internalFormat, data.width, data.height, 0, info.format, info.type, source);
+        }
+    }
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    glBindTexture(GL_TEXTURE_2D, 0);
+}
+
+// Block formats the driver can sample, asked once on the GL thread
+uint32_t TextureCache::getSupportedCompression() {
+    if (supportedCompression != ~0u) return supportedCompression;
+    supportedCompression = 0;
+    if (GLEW_EXT_texture_compression_s3tc) supportedCompression |= (1u << TEXTURE_COMPRESSION_BC1) | (1u << TEXTURE_COMPRESSION_BC3);
+    if (GLEW_ARB_texture_compression_bptc) supportedCompression |= 1u << TEXTURE_COMPRESSION_BC7;
+    return supportedCompression;
+}
+
+void TextureCache::setCookOptions(const char* pathPrefix, const TextureCookOptions& options) {
+    for (auto& entry : cookOptions) {
+        if (entry.first == pathPrefix) {
+            entry.second = options;
+            return;
+        }
+    }
+    cookOptions.emplace_back(pathPrefix, options);
+}
+
+const TextureCookOptions& TextureCache::getCookOptions(const char* filepath) const {
+    static const TextureCookOptions defaults;
+    const TextureCookOptions* best = &defaults;
+    size_t bestLength = 0;
+    for (const auto& entry : cookOptions) {
+        const std::string& prefix = entry.first;
+        bool matches = strncmp(filepath, prefix.c_str(), prefix.size()) == 0;
+        if (matches && (best == &defaults || prefix.size() > bestLength)) {
+            best = &entry.second;
+            bestLength = prefix.size();
+        }
+    }
+    return *best;
+}
+
+void TextureCache::loadTexture(Texture& texture) {
+    PendingImage pending;
+    pending.path = texture.path;
+    pending.options = getCookOptions(texture.path.c_str());
+    pending.supportedCompression = getSupportedCompression();
+    prepareImage(pending);
+    if (!pending.loaded) {
+        std::cout << "ERROR: Could not load texture: " << texture.path << std::endl;
+        texture.status = TEXTURE_FAILED;
+        return;
+    }
+    if (pending.cookWriteFailed) {
+        std::cout << "WARNING: Could not write cooked texture: " << pending.cookedPath << std::endl;
+    }
+    createTexture(texture, pending, pending.pixels);
+    texture.status = TEXTURE_READY;
+}
+
+void TextureCache::deleteTexture(Texture& texture) {
+    if (texture.id != 0) glDeleteTextures(1, &texture.id);
+    texture.id = 0;
+    texture.status = TEXTURE_UNLOADED;
+}
+
+TextureHandle TextureCache::reserveTexture(const char* filepath) {
+    TextureHandle handle = findTexture(filepath);
+    if (handle != INVALID_TEXTURE) return handle;
+
+    Texture texture;
+    texture.path = filepath;
+    textures.push_back(texture);
+    handle = (TextureHandle)textures.size();
+    handles[filepath] = handle;
+    return handle;
+}
+
+TextureHandle TextureCache::acquire(const char* filepath) {
+    TextureHandle handle = reserveTexture(filepath);
+
+    // Already loading in the background: finish that load instead of decoding again
+    while (textures[handle - 1].status == TEXTURE_LOADING) {
+        if (pumpUploads(0.0) == 0) std::this_thread::yield();
+    }
+
+    Texture& texture = textures[handle - 1];
+    if (texture.status == TEXTURE_UNLOADED) loadTexture(texture);
+    texture.refCount++;
+    return handle;
+}
+
+TextureHandle TextureCache::request(const char* filepath) {
+    TextureHandle handle = reserveTexture(filepath);
+    Texture& texture = textures[handle - 1];
+    texture.refCount++;
+    if (texture.status != TEXTURE_UNLOADED) return handle;
+
+    getFallback();
+    texture.status = TEXTURE_LOADING;
+    loadsInFlight++;
+
+    std::string path = texture.path;
+    TextureCookOptions options = getCookOptions(path.c_str());
+    uint32_t supported = getSupportedCompression();
+    std::shared_ptr<PendingImageQueue> queue = finished;
+    ThreadPool::shared().submit([path, handle, options, supported, queue]() {
+        std::unique_ptr<PendingImage> pending(new PendingImage());
+        pending->path = path;
+        pending->handle = handle;
+        pending->options = options;
+        pending->supportedCompression = supported;
+        prepareImage(*pending);
+        // Full only while the GL thread is behind on uploads
+        while (!queue->push(pending)) {
+            std::this_thread::yield();
+        }
+    });
+    return handle;
+}
+
+// Copy a prepared image into the next pixel buffer and start the transfer into a
+// new texture. Returns false if that buffer's previous copy is still running.
+bool TextureCache::uploadImage(PendingImage& image) {
+    UploadBuffer& buffer = uploadBuffers[nextUploadBuffer];
+    if (buffer.fence != 0) return false;
+    nextUploadBuffer = (nextUploadBuffer + 1) % TEXTURE_UPLOAD_BUFFERS;
+
+    uint64_t size = image.info.dataSize;
+    if (buffer.pbo == 0) glGenBuffers(1, &buffer.pbo);
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, buffer.pbo);
+    glBufferData(GL_PIXEL_UNPACK_BUFFER, (GLsizeiptr)size, nullptr, GL_STREAM_DRAW);
+    buffer.size = size;
+    void* mapped = glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, (GLsizeiptr)size, GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT);
+    if (mapped) {
+        memcpy(mapped, image.pixels, size);
+        glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+    }
+    else {
+        glBufferSubData(GL_PIXEL_UNPACK_BUFFER, 0, (GLsizeiptr)size, image.pixels);
+    }
+
+    // The source is the bound pixel buffer, so this returns before the copy is done
+    createTexture(textures[image.handle - 1], image, nullptr);
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+    buffer.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    buffer.handle = image.handle;
+    return true;
+}
+
+void TextureCache::pollFences() {
+    for (UploadBuffer& buffer : uploadBuffers) {
+        if (buffer.fence == 0) continue;
+        GLenum result = glClientWaitSync(buffer.fence, GL_SYNC_FLUSH_COMMANDS_BIT, 0);
+        if (result != GL_ALREADY_SIGNALED && result != GL_CONDITION_SATISFIED) continue;
+
+        glDeleteSync(buffer.fence);
+        buffer.fence = 0;
+        textures[buffer.handle - 1].status = TEXTURE_READY;
+    }
+}
+
+size_t TextureCache::pumpUploads(double budgetMs) {
+    auto startTime = std::chrono::steady_clock::now();
+    pollFences();
+
+    size_t uploaded = 0;
+    while (waiting || (loadsInFlight > 0 && finished->pop(waiting))) {
+        Texture& texture = textures[waiting->handle - 1];
+        if (!waiting->loaded) {
+            std::cout << "ERROR: Could not load texture: " << texture.path << std::endl;
+            texture.status = TEXTURE_FAILED;
+        }
+        else if (!uploadImage(*waiting)) {
+            // Every buffer is busy; try again next frame
+            break;
+        }
+        else {
+            if (waiting->cookWriteFailed) {
+                std::cout << "WARNING: Could not write cooked texture: " << waiting->cookedPath << std::endl;
+            }
+            uploaded++;
+        }
+        loadsInFlight--;
+        waiting.reset();
+
+        double elapsedMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startTime).count();
+        if (elapsedMs >= budgetMs) break;
+    }
+    return uploaded;
+}
+
+size_t TextureCache::pendingLoads() const {
+    size_t pending = loadsInFlight;
+    for (const UploadBuffer& buffer : uploadBuffers) {
+        if (buffer.fence != 0) pending++;
+    }
+    return pending;
+}
+
+void TextureCache::release(TextureHandle handle) {
+    if (handle == INVALID_TEXTURE || handle > textures.size()) return;
+    Texture& texture = textures[handle - 1];
+    if (texture.refCount > 0) texture.refCount--;
+}
+
+TextureHandle TextureCache::findTexture(const char* filepath) const {
+    auto it = handles.find(filepath);
+    return it != handles.end() ? it->second : INVALID_TEXTURE;
+}
+
+unsigned int TextureCache::getFallback() {
+    if (fallback != 0) return fallback;
+
+    const unsigned char white[4] = { 255, 255, 255, 255 };
+    glGenTextures(1, &fallback);
+    glBindTexture(GL_TEXTURE_2D, fallback);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, 1, 1, 0, GL_RGBA, GL_UNSIGNED_BYTE, white);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    return fallback;
+}
+
+uint64_t TextureCache::purgeUnused() {
+    uint64_t freed = 0;
+    for (Texture& texture : textures) {
+        if (texture.refCount == 0 && texture.status == TEXTURE_READY) {
+            freed += texture.gpuBytes;
+            deleteTexture(texture);
+        }
+    }
+    return freed;
+}
+
+TextureCacheStats TextureCache::getStats() const {
+    TextureCacheStats stats = {};
+    stats.textures = textures.size();
+    for (const Texture& texture : textures) {
+        if (texture.status == TEXTURE_READY) {
+            stats.residentTextures++;
+            stats.gpuBytes += texture.gpuBytes;
+        }
+        else if (texture.status == TEXTURE_LOADING) {
+            stats.loadingTextures++;
+        }
+        if (texture.refCount > 0) stats.referencedTextures++;
+    }
+    for (const UploadBuffer& buffer : uploadBuffers) {
+        stats.stagingBytes += buffer.size;
+    }
+    return stats;
+}
+
+void TextureCache::clear() {
+    // Background loads still point at the slots; wait for them and drop the images
+    while (loadsInFlight > 0) {
+        if (waiting || finished->pop(waiting)) {
+            loadsInFlight--;
+            waiting.reset();
+        }
+        else {
+            std::this_thread::yield();
+        }
+    }
+
+    for (UploadBuffer& buffer : uploadBuffers) {
+        if (buffer.fence != 0) glDeleteSync(buffer.fence);
+        if (buffer.pbo != 0) glDeleteBuffers(1, &buffer.pbo);
+        buffer = UploadBuffer();
+    }
+    nextUploadBuffer = 0;
+
+    for (Texture& texture : textures) {
+        deleteTexture(texture);
+    }
+    if (fallback != 0) glDeleteTextures(1, &fallback);
+    fallback = 0;
+    textures.clear();
+    handles.clear();
+}
@@ -0,0 +1,474 @@
+#include "../Header/TextureCompression.h"
+#include "../Header/CookedTexture.h"
+#include "../Header/ThreadPool.h"
+#include <algorithm>
+#include <cmath>
+#include <cfloat>
+#include <cstring>
+#include <vector>
+
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#define COMPRESSION_SSE 1
+#include <xmmintrin.h>
+#endif
+
+// Palettes are kept channel by channel, padded to a multiple of four entries
+struct Palette {
+    float r[16], g[16], b[16], a[16];
+    int count;
+};
+
+// Nearest palette entry of every texel by squared distance (alpha weighted by
+// alphaWeight); returns the total error
+static float selectIndices(const float texels[16][4], const Palette& palette, float alphaWeight, uint8_t indices[16]) {
+    float total = 0.0f;
+    for (int i = 0; i < 16; i++) {
+#ifdef COMPRESSION_SSE
+        // Four palette entries per step; lanes keep their best distance and index
+        __m128 tr = _mm_set1_ps(texels[i][0]);
+        __m128 tg = _mm_set1_ps(texels[i][1]);
+        __m128 tb = _mm_set1_ps(texels[i][2]);
+        __m128 ta = _mm_set1_ps(texels[i][3]);
+        __m128 wa = _mm_set1_ps(alphaWeight);
+        __m128 bestDistance = _mm_set1_ps(FLT_MAX);
+        __m128 bestIndex = _mm_setzero_ps();
+        __m128 index = _mm_setr_ps(0.0f, 1.0f, 2.0f, 3.0f);
+        const __m128 four = _mm_set1_ps(4.0f);
+        for (int p = 0; p < palette.count; p += 4) {
+            __m128 dr = _mm_sub_ps(_mm_loadu_ps(palette.r + p), tr);
+            __m128 dg = _mm_sub_ps(_mm_loadu_ps(palette.g + p), tg);
+            __m128 db = _mm_sub_ps(_mm_loadu_ps(palette.b + p), tb);
+            __m128 da = _mm_sub_ps(_mm_loadu_ps(palette.a + p), ta);
+            __m128 distance = _mm_add_ps(_mm_add_ps(_mm_mul_ps(dr, dr), _mm_mul_ps(dg, dg)),
+                                         _mm_add_ps(_mm_mul_ps(db, db), _mm_mul_ps(wa, _mm_mul_ps(da, da))));
+            __m128 closer = _mm_cmplt_ps(distance, bestDistance);
+            bestDistance = _mm_min_ps(distance, bestDistance);
+            bestIndex = _mm_or_ps(_mm_and_ps(closer, index), _mm_andnot_ps(closer, bestIndex));
+            index = _mm_add_ps(index, four);
+        }
+        float distances[4], lanes[4];
+        _mm_storeu_ps(distances, bestDistance);
+        _mm_storeu_ps(lanes, bestIndex);
+        int best = 0;
+        for (int lane = 1; lane < 4; lane++) {
+            if (distances[lane] < distances[best] || (distances[lane] == distances[best] && lanes[lane] < lanes[best])) best = lane;
+        }
+        indices[i] = (uint8_t)lanes[best];
+        total += distances[best];
+#else
+        float bestDistance = FLT_MAX;
+        for (int p = 0; p < palette.count; p++) {
+            float dr = palette.r[p] - texels[i][0];
+            float dg = palette.g[p] - texels[i][1];
+            float db = palette.b[p] - texels[i][2];
+            float da = palette.a[p] - texels[i][3];
+            float distance = dr * dr + dg * dg + db * db + alphaWeight * da * da;
+            if (distance < bestDistance) {
+                bestDistance = distance;
+                indices[i] = (uint8_t)p;
+            }
+        }
+        total += bestDistance;
+#endif
+    }
+    return total;
+}
+
+// Endpoints spanning the texels: the bounding box diagonal (quality 0) or the
+// extent along the principal axis of the first channels channels
+static void fitEndpoints(const float texels[16][4], int channels, uint32_t quality, float e0[4], float e1[4]) {
+    float lo[4] = { FLT_MAX, FLT_MAX, FLT_MAX, FLT_MAX };
+    float hi[4] = { -FLT_MAX, -FLT_MAX, -FLT_MAX, -FLT_MAX };
+    float mean[4] = {};
+    for (int i = 0; i < 16; i++) {
+        for (int c = 0; c < 4; c++) {
+            lo[c] = std::min(lo[c], texels[i][c]);
+            hi[c] = std::max(hi[c], texels[i][c]);
+            mean[c] += texels[i][c] / 16.0f;
+        }
+    }
+    for (int c = 0; c < 4; c++) {
+        e0[c] = lo[c];
+        e1[c] = hi[c];
+    }
+    if (quality == 0) return;
+
+    float covariance[4][4] = {};
+    for (int i = 0; i < 16; i++) {
+        for (int a = 0; a < channels; a++) {
+            for (int b = 0; b < channels; b++) {
+                covariance[a][b] += (texels[i][a] - mean[a]) * (texels[i][b] - mean[b]);
+            }
+        }
+    }
+
+    // Power iteration from the box diagonal
+    float axis[4] = {};
+    for (int c = 0; c < channels; c++) axis[c] = hi[c] - lo[c];
+    for (int iteration = 0; iteration < 8; iteration++) {
+        float next[4] = {};
+        float length = 0.0f;
+        for (int a = 0; a < channels; a++) {
+            for (int b = 0; b < channels; b++) next[a] += covariance[a][b] * axis[b];
+            length = std::max(length, std::fabs(next[a]));
+        }
+        if (length < 1e-6f) return;    // Flat block: the box corners are exact
+        for (int c = 0; c < channels; c++) axis[c] = next[c] / length;
+    }
+
+    float tMin = FLT_MAX, tMax = -FLT_MAX;
+    float axisLength2 = 0.0f;
+    for (int c = 0; c < channels; c++) axisLength2 += axis[c] * axis[c];
+    for (int i = 0; i < 16; i++) {
+        float t = 0.0f;
+        for (int c = 0; c < channels; c++) t += (texels[i][c] - mean[c]) * axis[c];
+        tMin = std::min(tMin, t / axisLength2);
+        tMax = std::max(tMax, t / axisLength2);
+    }
+    for (int c = 0; c < channels; c++) {
+        e0[c] = std::min(255.0f, std::max(0.0f, mean[c] + tMin * axis[c]));
+        e1[c] = std::min(255.0f, std::max(0.0f, mean[c] + tMax * axis[c]));
+    }
+}
+
+// Endpoints minimizing the squared error for fixed indices, where texel i is
+// e0 * (1 - weights[indices[i]]) + e1 * weights[indices[i]]. False if the
+// indices do not determine two endpoints.
+static bool refitEndpoints(const float texels[16][4], const uint8_t indices[16], const float* weights, float e0[4], float e1[4]) {
+    float aa = 0.0f, ab = 0.0f, bb = 0.0f;
+    float ax[4] = {}, bx[4] = {};
+    for (int i = 0; i < 16; i++) {
+        float b = weights[indices[i]];
+        float a = 1.0f - b;
+        aa += a * a;
+        ab += a * b;
+        bb += b * b;
+        for (int c = 0; c < 4; c++) {
+            ax[c] += a * texels[i][c];
+            bx[c] += b * texels[i][c];
+        }
+    }
+    float determinant = aa * bb - ab * ab;
+    if (std::fabs(determinant) < 1e-6f) return false;
+    for (int c = 0; c < 4; c++) {
+        e0[c] = std::min(255.0f, std::max(0.0f, (ax[c] * bb - bx[c] * ab) / determinant));
+        e1[c] = std::min(255.0f, std::max(0.0f, (bx[c] * aa - ax[c] * ab) / determinant));
+    }
+    return true;
+}
+
+static void toFloatTexels(const uint8_t texels[64], float out[16][4]) {
+    for (int i = 0; i < 16; i++) {
+        for (int c = 0; c < 4; c++) out[i][c] = texels[i * 4 + c];
+    }
+}
+
+// --- BC1 ---
+
+static uint16_t packRGB565(const float color[4]) {
+    uint32_t r = (uint32_t)(color[0] * 31.0f / 255.0f + 0.5f);
+    uint32_t g = (uint32_t)(color[1] * 63.0f / 255.0f + 0.5f);
+    uint32_t b = (uint32_t)(color[2] * 31.0f / 255.0f + 0.5f);
+    return (uint16_t)((r << 11) | (g << 5) | b);
+}
+
+static void unpackRGB565(uint16_t packed, float color[4]) {
+    uint32_t r = (packed >> 11) & 31, g = (packed >> 5) & 63, b = packed & 31;
+    color[0] = (float)((r << 3) | (r >> 2));
+    color[1] = (float)((g << 2) | (g >> 4));
+    color[2] = (float)((b << 3) | (b >> 2));
+    color[3] = 255.0f;
+}
+
+// Quantize the endpoints and pick indices; four-color mode (c0 > c1) is always
+// used, so the block also decodes correctly inside BC3
+static float encodeColorEndpoints(const float texels[16][4], const float e0[4], const float e1[4], uint16_t& c0, uint16_t& c1, uint8_t indices[16]) {
+    c0 = packRGB565(e0);
+    c1 = packRGB565(e1);
+    if (c0 < c1) std::swap(c0, c1);
+    if (c0 == c1) {
+        std::memset(indices, 0, 16);
+        float color[4];
+        unpackRGB565(c0, color);
+        float error = 0.0f;
+        for (int i = 0; i < 16; i++) {
+            for (int c = 0; c < 3; c++) error += (texels[i][c] - color[c]) * (texels[i][c] - color[c]);
+        }
+        return error;
+    }
+
+    float p0[4], p1[4];
+    unpackRGB565(c0, p0);
+    unpackRGB565(c1, p1);
+    Palette palette = {};
+    palette.count = 4;
+    const float weights[4] = { 0.0f, 1.0f, 1.0f / 3.0f, 2.0f / 3.0f };
+    for (int p = 0; p < 4; p++) {
+        palette.r[p] = p0[0] + (p1[0] - p0[0]) * weights[p];
+        palette.g[p] = p0[1] + (p1[1] - p0[1]) * weights[p];
+        palette.b[p] = p0[2] + (p1[2] - p0[2]) * weights[p];
+    }
+    return selectIndices(texels, palette, 0.0f, indices);
+}
+
+static void encodeColorBlock(const uint8_t texels[64], uint32_t quality, uint8_t out[8]) {
+    float colors[16][4];
+    toFloatTexels(texels, colors);
+
+    float e0[4], e1[4];
+    fitEndpoints(colors, 3, quality, e0, e1);
+    uint16_t c0, c1;
+    uint8_t indices[16];
+    float error = encodeColorEndpoints(colors, e0, e1, c0, c1, indices);
+
+    // Refit to the chosen indices while that lowers the error
+    const float weights[4] = { 0.0f, 1.0f, 1.0f / 3.0f, 2.0f / 3.0f };
+    for (uint32_t iteration = 0; quality > 0 && iteration < 2 && c0 != c1; iteration++) {
+        float r0[4], r1[4];
+        if (!refitEndpoints(colors, indices, weights, r0, r1)) break;
+        uint16_t n0, n1;
+        uint8_t newIndices[16];
+        float newError = encodeColorEndpoints(colors, r0, r1, n0, n1, newIndices);
+        if (newError >= error) break;
+        error = newError;
+        c0 = n0;
+        c1 = n1;
+        std::memcpy(indices, newIndices, 16);
+    }
+
+    uint32_t bits = 0;
+    for (int i = 0; i < 16; i++) bits |= (uint32_t)indices[i] << (2 * i);
+    out[0] = (uint8_t)(c0 & 0xFF);
+    out[1] = (uint8_t)(c0 >> 8);
+    out[2] = (uint8_t)(c1 & 0xFF);
+    out[3] = (uint8_t)(c1 >> 8);
+    for (int i = 0; i < 4; i++) out[4 + i] = (uint8_t)(bits >> (8 * i));
+}
+
+void encodeBC1Block(const uint8_t texels[64], uint32_t quality, uint8_t out[8]) {
+    encodeColorBlock(texels, quality, out);
+}
+
+// --- BC3 ---
+
+// Eight-value alpha block (alpha0 > alpha1) spanning the block's alpha range
+static void encodeAlphaBlock(const uint8_t texels[64], uint8_t out[8]) {
+    uint8_t a0 = 0, a1 = 255;
+    for (int i = 0; i < 16; i++) {
+        a0 = std::max(a0, texels[i * 4 + 3]);
+        a1 = std::min(a1, texels[i * 4 + 3]);
+    }
+    out[0] = a0;
+    out[1] = a1;
+
+    uint64_t bits = 0;
+    if (a0 != a1) {
+        int palette[8] = { a0, a1 };
+        for (int p = 2; p < 8; p++) palette[p] = ((8 - p) * a0 + (p - 1) * a1) / 7;
+        for (int i = 0; i < 16; i++) {
+            int alpha = texels[i * 4 + 3];
+            int best = 0;
+            for (int p = 1; p < 8; p++) {
+                if (std::abs(palette[p] - alpha) < std::abs(palette[best] - alpha)) best = p;
+            }
+            bits |= (uint64_t)best << (3 * i);
+        }
+    }
+    for (int i = 0; i < 6; i++) out[2 + i] = (uint8_t)(bits >> (8 * i));
+}
+
+void encodeBC3Block(const uint8_t texels[64], uint32_t quality, uint8_t out[16]) {
+    encodeAlphaBlock(texels, out);
+    encodeColorBlock(texels, quality, out + 8);
+}
+
+// --- BC7 (mode 6: one subset, RGBA endpoints of 7 bits plus a p-bit, 4-bit indices) ---
+
+static const int BC7_WEIGHTS[16] = { 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+
+// Quantize an endpoint to 7 bits per channel plus the p-bit that fits it best
+static void quantizeBC7Endpoint(const float endpoint[4], uint8_t quantized[4], uint8_t& pbit) {
+    float bestError = FLT_MAX;
+    for (uint8_t p = 0; p < 2; p++) {
+        uint8_t q[4];
+        float error = 0.0f;
+        for (int c = 0; c < 4; c++) {
+            int value = (int)std::floor((endpoint[c] - p) / 2.0f + 0.5f);
+            q[c] = (uint8_t)std::min(127, std::max(0, value));
+            float decoded = (float)(q[c] * 2 + p);
+            error += (decoded - endpoint[c]) * (decoded - endpoint[c]);
+        }
+        if (error < bestError) {
+            bestError = error;
+            std::memcpy(quantized, q, 4);
+            pbit = p;
+        }
+    }
+}
+
+struct BC7Endpoints {
+    uint8_t q0[4], q1[4];
+    uint8_t p0, p1;
+};
+
+static float encodeBC7Endpoints(const float texels[16][4], const float e0[4], const float e1[4], BC7Endpoints& endpoints, uint8_t indices[16]) {
+    quantizeBC7Endpoint(e0, endpoints.q0, endpoints.p0);
+    quantizeBC7Endpoint(e1, endpoints.q1, endpoints.p1);
+
+    Palette palette = {};
+    palette.count = 16;
+    float* channels[4] = { palette.r, palette.g, palette.b, palette.a };
+    for (int c = 0; c < 4; c++) {
+        int v0 = endpoints.q0[c] * 2 + endpoints.p0;
+        int v1 = endpoints.q1[c] * 2 + endpoints.p1;
+        for (int p = 0; p < 16; p++) {
+            channels[c][p] = (float)(((64 - BC7_WEIGHTS[p]) * v0 + BC7_WEIGHTS[p] * v1 + 32) >> 6);
+        }
+    }
+    return selectIndices(texels, palette, 1.0f, indices);
+}
+
+// Little-endian bit stream of one 128-bit block
+struct BlockWriter {
+    uint8_t* out;
+    uint32_t position;
+
+    void write(uint32_t value, uint32_t bits) {
+        for (uint32_t i = 0; i < bits; i++, position++) {
+            if (value & (1u << i)) out[position >> 3] |= (uint8_t)(1u << (position & 7));
+        }
+    }
+};
+
+void encodeBC7Block(const uint8_t texels[64], uint32_t quality, uint8_t out[16]) {
+    float colors[16][4];
+    toFloatTexels(texels, colors);
+
+    float e0[4], e1[4];
+    fitEndpoints(colors, 4, quality, e0, e1);
+    BC7Endpoints endpoints;
+    uint8_t indices[16];
+    float error = encodeBC7Endpoints(colors, e0, e1, endpoints, indices);
+
+    float weights[16];
+    for (int p = 0; p < 16; p++) weights[p] = BC7_WEIGHTS[p] / 64.0f;
+    for (uint32_t iteration = 0; quality > 0 && iteration < 2; iteration++) {
+        float r0[4], r1[4];
+        if (!refitEndpoints(colors, indices, weights, r0, r1)) break;
+        BC7Endpoints refit;
+        uint8_t newIndices[16];
+        float newError = encodeBC7Endpoints(colors, r0, r1, refit, newIndices);
+        if (newError >= error) break;
+        error = newError;
+        endpoints = refit;
+        std::memcpy(indices, newIndices, 16);
+    }
+
+    // The first index is stored without its top bit, so it must be below 8
+    if (indices[0] >= 8) {
+        std::swap(endpoints.q0, endpoints.q1);
+        std::swap(endpoints.p0, endpoints.p1);
+        for (int i = 0; i < 16; i++) indices[i] = (uint8_t)(15 - indices[i]);
+    }
+
+    std::memset(out, 0, 16);
+    BlockWriter writer = { out, 0 };
+    writer.write(1u << 6, 7);    // Mode 6
+    for (int c = 0; c < 4; c++) {
+        writer.write(endpoints.q0[c], 7);
+        writer.write(endpoints.q1[c], 7);
+    }
+    writer.write(endpoints.p0, 1);
+    writer.write(endpoints.p1, 1);
+    writer.write(indices[0], 3);
+    for (int i = 1; i < 16; i++) writer.write(indices[i], 4);
+}
+
+// --- Textures ---
+
+uint32_t compressedBlockBytes(TextureCompression format) {
+    return format == TEXTURE_COMPRESSION_BC1 ? 8 : 16;
+}
+
+uint64_t compressedLevelSize(TextureCompression format, uint32_t width, uint32_t height) {
+    return (uint64_t)((width + 3) / 4) * ((height + 3) / 4) * compressedBlockBytes(format);
+}
+
+TextureCompression resolveCompression(TextureCompression requested, const TextureData& texture, uint32_t supported) {
+    if (requested == TEXTURE_COMPRESSION_NONE || texture.channels < 3) return TEXTURE_COMPRESSION_NONE;
+
+    if (requested == TEXTURE_COMPRESSION_AUTO) {
+        bool opaque = true;
+        if (texture.channels == 4) {
+            const CookedTextureLevel& level = texture.levels[0];
+            for (uint64_t i = 3; i < level.size && opaque; i += 4) opaque = texture.pixels[level.offset + i] == 255;
+        }
+        if (opaque && (supported & (1u << TEXTURE_COMPRESSION_BC1))) return TEXTURE_COMPRESSION_BC1;
+        if (supported & (1u << TEXTURE_COMPRESSION_BC7)) return TEXTURE_COMPRESSION_BC7;
+        if (supported & (1u << TEXTURE_COMPRESSION_BC3)) return TEXTURE_COMPRESSION_BC3;
+        return TEXTURE_COMPRESSION_NONE;
+    }
+    return (supported & (1u << requested)) ? requested : TEXTURE_COMPRESSION_NONE;
+}
+
+uint32_t compressionCandidates(TextureCompression requested) {
+    if (requested == TEXTURE_COMPRESSION_NONE) return 0;
+    if (requested == TEXTURE_COMPRESSION_AUTO) return TEXTURE_COMPRESSION_BLOCK_FORMATS;
+    return (1u << requested) & TEXTURE_COMPRESSION_BLOCK_FORMATS;
+}
+
+void compressTexture(TextureData& texture, TextureCompression format, uint32_t quality) {
+    static const uint32_t internalFormats[4] = { 0, GL_COMPRESSED_RGB_S3TC_DXT1_EXT, GL_COMPRESSED_RGBA_S3TC_DXT5_EXT,
+                                                 GL_COMPRESSED_RGBA_BPTC_UNORM };
+    if (format == TEXTURE_COMPRESSION_NONE || format == TEXTURE_COMPRESSION_AUTO) return;
+
+    std::vector<CookedTextureLevel> levels = texture.levels;
+    uint64_t total = 0;
+    for (CookedTextureLevel& level : levels) {
+        level.offset = total;
+        level.size = compressedLevelSize(format, level.width, level.height);
+        total += level.size;
+    }
+    std::vector<unsigned char> blocks(total);
+
+    // One job per row of blocks of every level
+    struct Job {
+        uint32_t level;
+        uint32_t blockRow;
+    };
+    std::vector<Job> jobs;
+    for (uint32_t level = 0; level < levels.size(); level++) {
+        for (uint32_t row = 0; row < (levels[level].height + 3) / 4; row++) jobs.push_back(Job{ level, row });
+    }
+
+    uint32_t channels = texture.channels;
+    uint32_t blockBytes = compressedBlockBytes(format);
+    ThreadPool::shared().parallelFor(jobs.size(), [&](size_t j) {
+        const CookedTextureLevel& source = texture.levels[jobs[j].level];
+        const CookedTextureLevel& target = levels[jobs[j].level];
+        const unsigned char* pixels = texture.pixels.data() + source.offset;
+        uint32_t blocksPerRow = (source.width + 3) / 4;
+        unsigned char* out = blocks.data() + target.offset + (uint64_t)jobs[j].blockRow * blocksPerRow * blockBytes;
+
+        for (uint32_t bx = 0; bx < blocksPerRow; bx++, out += blockBytes) {
+            // Edge blocks repeat the last row and column
+            uint8_t texels[64];
+            for (uint32_t y = 0; y < 4; y++) {
+                uint32_t sy = std::min(jobs[j].blockRow * 4 + y, source.height - 1);
+                for (uint32_t x = 0; x < 4; x++) {
+                    uint32_t sx = std::min(bx * 4 + x, source.width - 1);
+                    const unsigned char* texel = pixels + ((size_t)sy * source.width + sx) * channels;
+                    for (uint32_t c = 0; c < 4; c++) texels[(y * 4 + x) * 4 + c] = c < channels ? texel[c] : 255;
+                }
+            }
+            if (format == TEXTURE_COMPRESSION_BC1) encodeBC1Block(texels, quality, out);
+            else if (format == TEXTURE_COMPRESSION_BC3) encodeBC3Block(texels, quality, out);
+            else encodeBC7Block(texels, quality, out);
+        }
+    });
+
+    texture.levels = levels;
+    texture.pixels.swap(blocks);
+    texture.compression = format;
+    texture.internalFormat = internalFormats[format];
+}
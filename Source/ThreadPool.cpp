@@ -0,0 +1,88 @@
+#include "../Header/ThreadPool.h"
+#include <atomic>
+#include <memory>
+#include <algorithm>
+
+ThreadPool::ThreadPool(unsigned int threadCount) : stopping(false) {
+    if (threadCount == 0) threadCount = 1;
+    workers.reserve(threadCount);
+    for (unsigned int i = 0; i < threadCount; i++) {
+        workers.emplace_back(&ThreadPool::workerLoop, this);
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wake.notify_all();
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+}
+
+void ThreadPool::submit(std::function<void()> task) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        tasks.push_back(std::move(task));
+    }
+    wake.notify_one();
+}
+
+void ThreadPool::parallelFor(size_t count, const std::function<void(size_t)>& fn) {
+    if (count == 0) return;
+    if (count == 1) {
+        fn(0);
+        return;
+    }
+
+    // Shared with the helper tasks, which may start after this call returned;
+    // by then every index is claimed, so they never touch fn
+    struct Batch {
+        std::atomic<size_t> next{ 0 };
+        std::atomic<size_t> done{ 0 };
+        size_t count = 0;
+        const std::function<void(size_t)>* fn = nullptr;
+
+        void run() {
+            size_t i;
+            while ((i = next.fetch_add(1)) < count) {
+                (*fn)(i);
+                done.fetch_add(1, std::memory_order_release);
+            }
+        }
+    };
+    auto batch = std::make_shared<Batch>();
+    batch->count = count;
+    batch->fn = &fn;
+
+    size_t helpers = std::min(count - 1, workers.size());
+    for (size_t i = 0; i < helpers; i++) {
+        submit([batch]() { batch->run(); });
+    }
+
+    batch->run();
+    while (batch->done.load(std::memory_order_acquire) < count) {
+        std::this_thread::yield();
+    }
+}
+
+void ThreadPool::workerLoop() {
+    while (true) {
+        std::function<void()> task;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            wake.wait(lock, [this] { return stopping || !tasks.empty(); });
+            if (stopping && tasks.empty()) return;
+            task = std::move(tasks.front());
+            tasks.pop_front();
+        }
+        task();
+    }
+}
+
+ThreadPool& ThreadPool::shared() {
+    static ThreadPool pool(std::thread::hardware_concurrency() > 1 ? std::thread::hardware_concurrency() - 1 : 1);
+    return pool;
+}
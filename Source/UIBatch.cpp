@@ -0,0 +1,75 @@
+#include "../Header/UIBatch.h"
+#include <cstddef>
+
+UIBatch::UIBatch() : VAO(0), VBO(0), capacity(0) {
+    glGenVertexArrays(1, &VAO);
+    glGenBuffers(1, &VBO);
+    glBindVertexArray(VAO);
+    glBindBuffer(GL_ARRAY_BUFFER, VBO);
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(UIVertex), (void*)offsetof(UIVertex, x));
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, sizeof(UIVertex), (void*)offsetof(UIVertex, u));
+    glEnableVertexAttribArray(1);
+    glVertexAttribPointer(3, 4, GL_FLOAT, GL_FALSE, sizeof(UIVertex), (void*)offsetof(UIVertex, r));
+    glEnableVertexAttribArray(3);
+    glBindVertexArray(0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    // No other vertex array has colors; they read this constant instead (flush
+    // sets it again after every draw that used the color array)
+    glVertexAttrib4f(3, 1.0f, 1.0f, 1.0f, 1.0f);
+}
+
+UIBatch::~UIBatch() {
+    if (VBO != 0) glDeleteBuffers(1, &VBO);
+    if (VAO != 0) glDeleteVertexArrays(1, &VAO);
+}
+
+void UIBatch::add(const GameObject& obj, const AtlasRegion& region) {
+    if (!obj.isVisible) return;
+
+    float left = obj.x - obj.w * 0.5f, right = obj.x + obj.w * 0.5f;
+    float bottom = obj.y - obj.h * 0.5f, top = obj.y + obj.h * 0.5f;
+    UIVertex corners[4] = {
+        { left,  top,    0.0f, region.u0, region.v1, obj.r, obj.g, obj.b, obj.a },
+        { left,  bottom, 0.0f, region.u0, region.v0, obj.r, obj.g, obj.b, obj.a },
+        { right, top,    0.0f, region.u1, region.v1, obj.r, obj.g, obj.b, obj.a },
+        { right, bottom, 0.0f, region.u1, region.v0, obj.r, obj.g, obj.b, obj.a }
+    };
+
+    // Two triangles per quad, so quads need no strip restarts between them
+    static const int order[6] = { 0, 1, 2, 2, 1, 3 };
+    for (int i : order) vertices.push_back(corners[i]);
+}
+
+void UIBatch::flush(ShaderVariants& shaders, const TextureAtlas& atlas) {
+    if (vertices.empty()) return;
+
+    // Everything samples the atlas (plain quads its white region), unlit and unrounded
+    ShaderProgram& shader = shaders.get(SHADER_TEXTURED);
+    shader.use();
+
+    // Vertices are already in UI space; the object color comes from the vertices
+    shader.set(UNIFORM_MODEL, glm::mat4(1.0f));
+    shader.set(UNIFORM_COLOR, glm::vec4(1.0f));
+    shader.set(UNIFORM_MATERIAL_INDEX, 0);
+
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, atlas.getId());
+
+    // Orphan the buffer every frame so the driver never waits for last frame's draw
+    glBindBuffer(GL_ARRAY_BUFFER, VBO);
+    if (vertices.size() > capacity) capacity = vertices.size();
+    glBufferData(GL_ARRAY_BUFFER, capacity * sizeof(UIVertex), nullptr, GL_STREAM_DRAW);
+    glBufferSubData(GL_ARRAY_BUFFER, 0, vertices.size() * sizeof(UIVertex), vertices.data());
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    glBindVertexArray(VAO);
+    glDrawArrays(GL_TRIANGLES, 0, (GLsizei)vertices.size());
+    glBindVertexArray(0);
+
+    // A draw that reads attribute 3 from an array leaves its constant undefined
+    glVertexAttrib4f(3, 1.0f, 1.0f, 1.0f, 1.0f);
+
+    vertices.clear();
+}
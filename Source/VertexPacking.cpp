@@ -0,0 +1,89 @@
+#include "../Header/VertexPacking.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+uint16_t floatToHalf(float value) {
+    uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    uint32_t sign = (bits >> 16) & 0x8000;
+    uint32_t exponent = (bits >> 23) & 0xFF;
+    uint32_t mantissa = bits & 0x7FFFFF;
+
+    // Infinity and NaN
+    if (exponent == 0xFF) return (uint16_t)(sign | 0x7C00 | (mantissa ? 0x200 : 0));
+
+    int halfExponent = (int)exponent - 127 + 15;
+    if (halfExponent >= 31) return (uint16_t)(sign | 0x7C00);
+
+    if (halfExponent <= 0) {
+        // Subnormal half (or zero)
+        if (halfExponent < -10) return (uint16_t)sign;
+        mantissa |= 0x800000;
+        uint32_t shift = (uint32_t)(14 - halfExponent);
+        uint32_t half = mantissa >> shift;
+        uint32_t rest = mantissa & ((1u << shift) - 1);
+        uint32_t halfway = 1u << (shift - 1);
+        if (rest > halfway || (rest == halfway && (half & 1))) half++;
+        return (uint16_t)(sign | half);
+    }
+
+    uint32_t half = ((uint32_t)halfExponent << 10) | (mantissa >> 13);
+    uint32_t rest = mantissa & 0x1FFF;
+    // A carry out of the mantissa correctly bumps the exponent
+    if (rest > 0x1000 || (rest == 0x1000 && (half & 1))) half++;
+    return (uint16_t)(sign | half);
+}
+
+bool canPackVertices(const MeshData& mesh) {
+    if (mesh.vertices.empty()) return false;
+    for (const Vertex& v : mesh.vertices) {
+        if (!std::isfinite(v.x) || !std::isfinite(v.y) || !std::isfinite(v.z)) return false;
+        if (!(std::fabs(v.u) <= MAX_PACKED_TEXCOORD) || !(std::fabs(v.v) <= MAX_PACKED_TEXCOORD)) return false;
+    }
+    return true;
+}
+
+// Signed normalized 10-bit component of a 2_10_10_10 value
+static uint32_t packSnorm10(float value) {
+    int q = (int)std::lround(std::min(1.0f, std::max(-1.0f, value)) * 511.0f);
+    return (uint32_t)q & 0x3FF;
+}
+
+static int16_t packSnorm16(float value) {
+    return (int16_t)std::lround(std::min(1.0f, std::max(-1.0f, value)) * 32767.0f);
+}
+
+void packVertices(MeshData& mesh) {
+    // Center the AABB on the origin and scale its largest half-extent to 1
+    float halfExtent = 0.0f;
+    for (int axis = 0; axis < 3; axis++) {
+        mesh.positionOffset[axis] = mesh.bounds.center[axis];
+        halfExtent = std::max(halfExtent, (mesh.bounds.max[axis] - mesh.bounds.min[axis]) * 0.5f);
+    }
+    mesh.positionScale = halfExtent > 0.0f ? halfExtent : 1.0f;
+    float invScale = 1.0f / mesh.positionScale;
+
+    mesh.packedVertices.resize(mesh.vertices.size());
+    for (size_t i = 0; i < mesh.vertices.size(); i++) {
+        const Vertex& v = mesh.vertices[i];
+        PackedVertex& p = mesh.packedVertices[i];
+
+        p.x = packSnorm16((v.x - mesh.positionOffset[0]) * invScale);
+        p.y = packSnorm16((v.y - mesh.positionOffset[1]) * invScale);
+        p.z = packSnorm16((v.z - mesh.positionOffset[2]) * invScale);
+        p.w = 0;
+
+        float length = std::sqrt(v.nx * v.nx + v.ny * v.ny + v.nz * v.nz);
+        float nx = 0.0f, ny = 1.0f, nz = 0.0f;
+        if (length > 0.0f) {
+            nx = v.nx / length;
+            ny = v.ny / length;
+            nz = v.nz / length;
+        }
+        p.normal = packSnorm10(nx) | (packSnorm10(ny) << 10) | (packSnorm10(nz) << 20);
+
+        p.u = floatToHalf(v.u);
+        p.v = floatToHalf(v.v);
+    }
+}